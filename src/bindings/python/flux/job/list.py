@@ -20,17 +20,54 @@ from flux.rpc import RPC
 
 
 class JobListRPC(RPC):
+    def __init__(self, *args, **kwargs):
+        super().__init__(*args, **kwargs)
+        self.streaming = bool(
+            kwargs.get("flags", 0) & flux.constants.FLUX_RPC_STREAMING
+        )
+        self._jobs = None
+
+    def _chunks(self):
+        """Yield each array of jobs returned by the RPC.
+
+        A streaming RPC returns jobs over multiple responses, terminated
+        by ENODATA.
+        """
+        if not self.streaming:
+            yield self.get()["jobs"]
+            return
+        while True:
+            try:
+                jobs = self.get()["jobs"]
+            except OSError as exc:
+                if exc.errno == errno.ENODATA:
+                    return
+                raise
+            yield jobs
+            self.reset()
+
     def get_jobs(self):
         """Returns all jobs in the RPC."""
-        return self.get()["jobs"]
+        if self._jobs is None:
+            self._jobs = []
+            for jobs in self._chunks():
+                self._jobs.extend(jobs)
+        return self._jobs
 
     def get_jobinfos(self):
         """Yields a JobInfo object for each job in its current state.
 
+        For a streaming RPC, jobs are yielded as each response arrives.
+
         :rtype: JobInfo
         """
-        for job in self.get_jobs():
-            yield JobInfo(job)
+        if self._jobs is not None:
+            chunks = [self._jobs]
+        else:
+            chunks = self._chunks()
+        for jobs in chunks:
+            for job in jobs:
+                yield JobInfo(job)
 
 
 # Due to subtleties in the python bindings and this call, this binding
@@ -52,6 +89,7 @@ def job_list(
     name=None,
     queue=None,
     constraint=None,
+    chunk_size=None,
 ):
     if constraint is None:
         # N.B. an "and" operation with no values returns everything
@@ -85,7 +123,11 @@ def job_list(
         "since": since,
         "constraint": constraint,
     }
-    return JobListRPC(flux_handle, "job-list.list", payload)
+    flags = 0
+    if chunk_size is not None:
+        payload["chunk_size"] = int(chunk_size)
+        flags = flux.constants.FLUX_RPC_STREAMING
+    return JobListRPC(flux_handle, "job-list.list", payload, flags=flags)
 
 
 def job_list_inactive(
@@ -224,6 +266,8 @@ class JobList:
         as documented in RFC 43 Constraint Operators section. This constraint
         may then be joined with other constraints provided by above parameters
         via the ``and`` operator.
+    :chunk_size: If set, stream jobs from the job-list module in responses
+        of at most ``chunk_size`` jobs instead of a single response.
     """
 
     # pylint: disable=too-many-instance-attributes
@@ -258,6 +302,7 @@ class JobList:
         name=None,
         queue=None,
         constraint=None,
+        chunk_size=None,
     ):
         self.handle = flux_handle
         self.attrs = list(attrs)
@@ -274,6 +319,7 @@ class JobList:
                 self.add_filter(x)
         self.set_user(user)
         self.constraint = constraint
+        self.chunk_size = chunk_size
 
     def set_user(self, user):
         """Only return jobs for user (may be a username, userid, or "all")"""
@@ -326,6 +372,7 @@ class JobList:
             name=self.name,
             queue=self.queue,
             constraint=self.constraint,
+            chunk_size=self.chunk_size,
         )
 
     def jobs(self):
@@ -337,6 +384,8 @@ class JobList:
         from the underlying job listing RPC.
         """
         rpc = self.fetch_jobs()
+        if isinstance(rpc, JobListRPC):
+            return list(rpc.get_jobinfos())
         jobs = rpc.get_jobs()
         if hasattr(rpc, "errors"):
             self.errors = rpc.errors
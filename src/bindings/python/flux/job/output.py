@@ -133,7 +133,9 @@ class LogEvent(EventLogEvent):
     Attributes:
         timestamp (float): timestamp for this log event
         name (str): name of this event: 'log'
-        rank (Taskset): shell rank that produced the log message
+        rank (Taskset): shell rank(s) that produced the log message. A
+            message merged from several shells has an RFC 22 idset string
+            rank in the eventlog, e.g. "0-3"
         level (int): log level
         levelstr (str): log level string
         message (str): log message
@@ -118,8 +118,13 @@ def need_instance_info(fields):
 
 # pylint: disable=too-many-branches
 def fetch_jobs_flux(args, fields, flux_handle=None):
+    #  Stream job listings from the local instance.  Child instances
+    #  queried with --recursive may run an older job-list module that
+    #  does not support streaming, so use a single response there.
+    chunk_size = None
     if not flux_handle:
         flux_handle = flux.Flux()
+        chunk_size = 1000
 
     attrs = job_fields_to_attrs(fields)
 
@@ -184,6 +189,7 @@ def fetch_jobs_flux(args, fields, flux_handle=None):
         name=args.name,
         queue=args.queue,
         constraint=constraint,
+        chunk_size=chunk_size,
     )
 
     jobs = jobs_rpc.jobs()
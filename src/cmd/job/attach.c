@@ -15,6 +15,7 @@
 #endif
 #include <unistd.h>
 #include <stdio.h>
+#include <string.h>
 #include <jansson.h>
 #include <sys/ioctl.h>
 #include <signal.h>
@@ -255,9 +256,22 @@ static void handle_output_data (struct attach_ctx *ctx, json_t *context)
     else
         fp = stderr;
     if (len > 0) {
-        if (optparse_hasopt (ctx->p, "label-io"))
-            fprintf (fp, "%s: ", rank);
-        fwrite (data, len, 1, fp);
+        if (optparse_hasopt (ctx->p, "label-io")) {
+            /*  Data may contain multiple lines, label each one.
+             */
+            char *cp = data;
+            int n = len;
+            while (n > 0) {
+                char *nl = memchr (cp, '\n', n);
+                int linelen = nl ? nl - cp + 1 : n;
+                fprintf (fp, "%s: ", rank);
+                fwrite (cp, linelen, 1, fp);
+                cp += linelen;
+                n -= linelen;
+            }
+        }
+        else
+            fwrite (data, len, 1, fp);
         /*  If attached to a pty, terminal is in raw mode so a carriage
          *  return will be necessary to return cursor to the start of line.
          */
@@ -299,6 +313,36 @@ static const char *levelstr[] = {
     "FATAL", "FATAL", "FATAL", "ERROR", " WARN", NULL, "DEBUG", "TRACE"
 };
 
+static void print_output_log (struct attach_ctx *ctx,
+                              double ts,
+                              int rank,
+                              int level,
+                              const char *msg,
+                              const char *component,
+                              const char *file,
+                              int line)
+{
+    const char *label = levelstr [level];
+    fprintf (stderr, "%.3fs: flux-shell", ts - ctx->timestamp_zero);
+    if (rank >= 0)
+        fprintf (stderr, "[%d]", rank);
+    if (label)
+        fprintf (stderr, ": %s", label);
+    if (component)
+        fprintf (stderr, ": %s", component);
+    if (optparse_hasopt (ctx->p, "verbose") && file) {
+        fprintf (stderr, ": %s", file);
+        if (line > 0)
+            fprintf (stderr, ":%d", line);
+    }
+    fprintf (stderr, ": %s\n", msg);
+    /*  If attached to a pty, terminal is in raw mode so a carriage
+     *  return will be necessary to return cursor to the start of line.
+     */
+    if (ctx->pty_client)
+        fprintf (stderr, "\r");
+}
+
 static void handle_output_log (struct attach_ctx *ctx,
                                double ts,
                                json_t *context)
@@ -306,7 +350,7 @@ static void handle_output_log (struct attach_ctx *ctx,
     const char *msg = NULL;
     const char *file = NULL;
     const char *component = NULL;
-    int rank = -1;
+    json_t *rank = NULL;
     int line = -1;
     int level = -1;
     json_error_t err;
@@ -314,7 +358,7 @@ static void handle_output_log (struct attach_ctx *ctx,
     if (json_unpack_ex (context,
                         &err,
                         0,
-                        "{ s?i s:i s:s s?s s?s s?i }",
+                        "{ s?o s:i s:s s?s s?s s?i }",
                         "rank", &rank,
                         "level", &level,
                         "message", &msg,
@@ -324,26 +368,36 @@ static void handle_output_log (struct attach_ctx *ctx,
         log_err ("invalid log event in guest.output: %s", err.text);
         return;
     }
-    if (!optparse_hasopt (ctx->p, "quiet")) {
-        const char *label = levelstr [level];
-        fprintf (stderr, "%.3fs: flux-shell", ts - ctx->timestamp_zero);
-        if (rank >= 0)
-            fprintf (stderr, "[%d]", rank);
-        if (label)
-            fprintf (stderr, ": %s", label);
-        if (component)
-            fprintf (stderr, ": %s", component);
-        if (optparse_hasopt (ctx->p, "verbose") && file) {
-            fprintf (stderr, ": %s", file);
-            if (line > 0)
-                fprintf (stderr, ":%d", line);
+    if (optparse_hasopt (ctx->p, "quiet"))
+        return;
+    /*  "rank" is an RFC 22 idset string if the leader shell merged the
+     *  same message from multiple shells.  Print it once per shell rank.
+     */
+    if (json_is_string (rank)) {
+        struct idset *ranks;
+        unsigned int id;
+
+        if (!(ranks = idset_decode (json_string_value (rank)))) {
+            log_msg ("invalid rank in guest.output log event");
+            return;
         }
-        fprintf (stderr, ": %s\n", msg);
-        /*  If attached to a pty, terminal is in raw mode so a carriage
-         *  return will be necessary to return cursor to the start of line.
-         */
-        if (ctx->pty_client)
-            fprintf (stderr, "\r");
+        id = idset_first (ranks);
+        while (id != IDSET_INVALID_ID) {
+            print_output_log (ctx, ts, id, level, msg, component, file, line);
+            id = idset_next (ranks, id);
+        }
+        idset_destroy (ranks);
+    }
+    else {
+        int id = json_is_integer (rank) ? json_integer_value (rank) : -1;
+        print_output_log (ctx,
+                          ts,
+                          id,
+                          level,
+                          msg,
+                          component,
+                          file,
+                          line);
     }
 }
 
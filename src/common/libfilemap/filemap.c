@@ -30,6 +30,23 @@
 
 #include "fileref.h"
 
+/* Maximum number of content.load requests in flight during extraction.
+ * Blobs are at most the archive chunksize (1M by default), so this also
+ * bounds memory used by blobs that have been fetched but not yet written.
+ */
+#define FETCH_WINDOW 16
+
+/* Blob prefetcher.  All blobrefs of an archive are listed in extraction
+ * order up front, then up to FETCH_WINDOW of them are kept loading
+ * while earlier blobs are written, across file boundaries.
+ */
+struct fetch {
+    flux_t *h;
+    json_t *blobrefs;           // array of blobref strings
+    size_t head;                // index of next blobref to be consumed
+    size_t next;                // index of next blobref to be requested
+    flux_future_t *window[FETCH_WINDOW];
+};
 
 /* Decode the raw data field a fileref object, setting the result in 'data'
  * and 'data_size'.  Caller must free.
@@ -69,7 +86,126 @@ static const char *fixup_archive_error_string (struct archive *archive)
     return errstr;
 }
 
-static int extract_blob (flux_t *h,
+static void fetch_destroy (struct fetch *fetch)
+{
+    if (fetch) {
+        int saved_errno = errno;
+        for (int i = 0; i < FETCH_WINDOW; i++)
+            flux_future_destroy (fetch->window[i]);
+        json_decref (fetch->blobrefs);
+        free (fetch);
+        errno = saved_errno;
+    }
+}
+
+/* Append the blobrefs of 'fileref' to 'blobrefs', if its data would be
+ * extracted with the blobvec encoding.  Malformed entries are skipped
+ * here and reported when the file is extracted.
+ */
+static int fetch_add_fileref (json_t *blobrefs, json_t *fileref)
+{
+    int mode;
+    const char *encoding = NULL;
+    json_t *data = NULL;
+    size_t index;
+    json_t *o;
+
+    if (json_unpack (fileref,
+                     "{s:i s?s s?o}",
+                     "mode", &mode,
+                     "encoding", &encoding,
+                     "data", &data) < 0
+        || !S_ISREG (mode)
+        || !data
+        || !encoding
+        || !streq (encoding, "blobvec"))
+        return 0;
+    json_array_foreach (data, index, o) {
+        json_t *blobref;
+
+        if (json_unpack (o, "[I,I,o]", NULL, NULL, &blobref) < 0
+            || !json_is_string (blobref))
+            continue;
+        if (json_array_append (blobrefs, blobref) < 0) {
+            errno = ENOMEM;
+            return -1;
+        }
+    }
+    return 0;
+}
+
+/* Keep up to FETCH_WINDOW content.load requests in flight.  If a request
+ * cannot be sent, stop here and let fetch_get() send it synchronously.
+ */
+static void fetch_fill (struct fetch *fetch)
+{
+    while (fetch->next < json_array_size (fetch->blobrefs)
+           && fetch->next - fetch->head < FETCH_WINDOW) {
+        json_t *o = json_array_get (fetch->blobrefs, fetch->next);
+        flux_future_t *f;
+
+        if (!(f = content_load_byblobref (fetch->h,
+                                          json_string_value (o),
+                                          0)))
+            break;
+        fetch->window[fetch->next % FETCH_WINDOW] = f;
+        fetch->next++;
+    }
+}
+
+static struct fetch *fetch_create (flux_t *h, json_t *files)
+{
+    struct fetch *fetch;
+    const char *key;
+    size_t index;
+    json_t *entry;
+
+    if (!(fetch = calloc (1, sizeof (*fetch)))
+        || !(fetch->blobrefs = json_array ()))
+        goto nomem;
+    fetch->h = h;
+    if (json_is_array (files)) {
+        json_array_foreach (files, index, entry) {
+            if (fetch_add_fileref (fetch->blobrefs, entry) < 0)
+                goto error;
+        }
+    }
+    else {
+        json_object_foreach (files, key, entry) {
+            if (fetch_add_fileref (fetch->blobrefs, entry) < 0)
+                goto error;
+        }
+    }
+    fetch_fill (fetch);
+    return fetch;
+nomem:
+    errno = ENOMEM;
+error:
+    fetch_destroy (fetch);
+    return NULL;
+}
+
+/* Return a future for 'blobref', which the caller must destroy.
+ * Normally this is the oldest prefetched request.  Otherwise, e.g. if
+ * fetch_fill() could not send it, the request is sent now.
+ */
+static flux_future_t *fetch_get (struct fetch *fetch, const char *blobref)
+{
+    flux_future_t *f;
+    json_t *o;
+
+    if (fetch->head == fetch->next
+        || !(o = json_array_get (fetch->blobrefs, fetch->head))
+        || !streq (json_string_value (o), blobref))
+        return content_load_byblobref (fetch->h, blobref, 0);
+    f = fetch->window[fetch->head % FETCH_WINDOW];
+    fetch->window[fetch->head % FETCH_WINDOW] = NULL;
+    fetch->head++;
+    fetch_fill (fetch);
+    return f;
+}
+
+static int extract_blob (struct fetch *fetch,
                          struct archive *archive,
                          const char *path,
                          json_t *o,
@@ -90,7 +226,7 @@ static int extract_blob (flux_t *h,
                      &entry.size,
                      &entry.blobref) < 0)
         return errprintf (errp, "%s: error decoding blobvec entry", path);
-    if (!(f = content_load_byblobref (h, entry.blobref, 0))
+    if (!(f = fetch_get (fetch, entry.blobref))
         || content_load_get (f, &buf, &size) < 0) {
         return errprintf (errp,
                           "%s: error loading offset=%ju size=%ju from %s: %s",
@@ -127,7 +263,7 @@ static int extract_blob (flux_t *h,
  *  libarchive object 'archive' and using 'path' as the default path
  *  if no path is encoded in 'fileref'.
  */
-static int extract_file (flux_t *h,
+static int extract_file (struct fetch *fetch,
                          struct archive *archive,
                          const char *path,
                          json_t *fileref,
@@ -237,7 +373,7 @@ static int extract_file (flux_t *h,
         }
         else if (streq (encoding, "blobvec")) {
             json_array_foreach (data, index, o) {
-                if (extract_blob (h, archive, path, o, errp) < 0)
+                if (extract_blob (fetch, archive, path, o, errp) < 0)
                     return -1;
             }
         }
@@ -279,9 +415,14 @@ int filemap_extract (flux_t *h,
     const char *key;
     size_t index;
     json_t *entry;
-    struct archive *archive;
+    struct archive *archive = NULL;
+    struct fetch *fetch = NULL;
     int rc = -1;
 
+    if (!(fetch = fetch_create (h, files))) {
+        errprintf (errp, "error preparing to fetch file content");
+        goto out;
+    }
     if (!(archive = archive_write_disk_new ())
         || archive_write_disk_set_options (archive,
                                            libarchive_flags) != ARCHIVE_OK) {
@@ -291,7 +432,7 @@ int filemap_extract (flux_t *h,
 
     if (json_is_array (files)) {
         json_array_foreach (files, index, entry) {
-            if (extract_file (h,
+            if (extract_file (fetch,
                               archive,
                               NULL,
                               entry,
@@ -302,7 +443,7 @@ int filemap_extract (flux_t *h,
         }
     } else {
         json_object_foreach (files, key, entry) {
-            if (extract_file (h,
+            if (extract_file (fetch,
                               archive,
                               key,
                               entry,
@@ -316,6 +457,7 @@ int filemap_extract (flux_t *h,
 out:
     if (archive)
         archive_write_free (archive);
+    fetch_destroy (fetch);
     return rc;
 }
 
@@ -35,6 +35,11 @@
 #define UUID_STR_LEN 37     // defined in later libuuid headers
 #endif
 
+/* Maximum number of topic strings for which the result of handler
+ * matching is cached.  The cache is cleared when this is reached.
+ */
+#define MATCH_CACHE_MAX 1024
+
 static int use_deepbind = 1;
 static pthread_once_t deepbind_once = PTHREAD_ONCE_INIT;
 
@@ -62,6 +67,7 @@ struct flux_plugin {
     struct aux_item *aux;
     void *dso;
     zlistx_t *handlers;
+    zhashx_t *match_cache;  // topic string => matching handler
     int flags;
     char last_error [128];
     uuid_t uuid;
@@ -106,16 +112,35 @@ static const struct flux_plugin_handler * find_handler (flux_plugin_t *p,
     return NULL;
 }
 
+/* Placeholder stored in match_cache for topics with no matching handler.
+ */
+static const struct flux_plugin_handler no_handler;
+
+/* Return the first handler whose topic glob matches 'string'.  Since
+ * the same few topics tend to be called repeatedly, the result, including
+ * no match, is cached so that fnmatch(3) is only run against the handler
+ * list once per topic until handlers are added or removed.
+ */
 static const struct flux_plugin_handler * match_handler (flux_plugin_t *p,
                                                          const char *string)
 {
-    struct flux_plugin_handler *h = zlistx_first (p->handlers);
+    struct flux_plugin_handler *h;
+
+    if ((h = zhashx_lookup (p->match_cache, string)))
+        return h == &no_handler ? NULL : h;
+
+    h = zlistx_first (p->handlers);
     while (h) {
         if (fnmatch (h->topic, string, 0) == 0)
-            return h;
+            break;
         h = zlistx_next (p->handlers);
     }
-    return NULL;
+    if (zhashx_size (p->match_cache) >= MATCH_CACHE_MAX)
+        zhashx_purge (p->match_cache);
+    (void) zhashx_insert (p->match_cache,
+                          string,
+                          h ? h : (void *) &no_handler);
+    return h;
 }
 
 static struct flux_plugin_handler *
@@ -138,6 +163,7 @@ void flux_plugin_destroy (flux_plugin_t *p)
         int saved_errno = errno;
         json_decref (p->conf);
         zlistx_destroy (&p->handlers);
+        zhashx_destroy (&p->match_cache);
         free (p->conf_str);
         free (p->path);
         free (p->name);
@@ -177,7 +203,9 @@ static inline void plugin_error_clear (flux_plugin_t *p)
 flux_plugin_t *flux_plugin_create (void)
 {
     flux_plugin_t *p = calloc (1, sizeof (*p));
-    if (!p || !(p->handlers = zlistx_new ())) {
+    if (!p
+        || !(p->handlers = zlistx_new ())
+        || !(p->match_cache = zhashx_new ())) {
         flux_plugin_destroy (p);
         return NULL;
     }
@@ -388,6 +416,7 @@ int flux_plugin_remove_handler (flux_plugin_t *p,
     if (find_handler (p, topic)) {
         if (zlistx_delete (p->handlers, zlistx_cursor (p->handlers)) < 0)
             return plugin_seterror (p, errno, NULL);
+        zhashx_purge (p->match_cache);
     }
     return 0;
 }
@@ -438,6 +467,7 @@ int flux_plugin_add_handler (flux_plugin_t *p,
         flux_plugin_handler_destroy (h);
         return plugin_seterror (p, errno, NULL);
     }
+    zhashx_purge (p->match_cache);
 
     return 0;
 }
@@ -298,6 +298,12 @@ int op1 (flux_plugin_t *p, const char *topic,
     return 0;
 }
 
+int op2 (flux_plugin_t *p, const char *topic,
+         flux_plugin_arg_t *args, void *data)
+{
+    return 0;
+}
+
 void test_basic ()
 {
     int a, b;
@@ -360,6 +366,38 @@ void test_basic ()
     flux_plugin_destroy (p);
 }
 
+void test_match_cache ()
+{
+    flux_plugin_t *p = flux_plugin_create ();
+    if (!p)
+        BAIL_OUT ("flux_plugin_create failed");
+
+    ok (flux_plugin_match_handler (p, "op.add") == NULL,
+        "flux_plugin_match_handler (p, 'op.add') returns NULL initially");
+    ok (flux_plugin_add_handler (p, "op.*", op1, NULL) == 0,
+        "flux_plugin_add_handler (p, 'op.*') works");
+    ok (flux_plugin_match_handler (p, "op.add") == op1,
+        "flux_plugin_match_handler (p, 'op.add') returns op1 after add");
+    ok (flux_plugin_match_handler (p, "op.add") == op1,
+        "flux_plugin_match_handler (p, 'op.add') returns op1 again");
+    ok (flux_plugin_add_handler (p, "op.add", op2, NULL) == 0,
+        "flux_plugin_add_handler (p, 'op.add') works");
+    ok (flux_plugin_match_handler (p, "op.add") == op1,
+        "first matching handler still wins after add");
+    ok (flux_plugin_remove_handler (p, "op.*") == 0,
+        "flux_plugin_remove_handler (p, 'op.*') works");
+    ok (flux_plugin_match_handler (p, "op.add") == op2,
+        "flux_plugin_match_handler (p, 'op.add') returns op2 after remove");
+    ok (flux_plugin_match_handler (p, "op.multiply") == NULL,
+        "flux_plugin_match_handler (p, 'op.multiply') returns NULL");
+    ok (flux_plugin_add_handler (p, "op.add", NULL, NULL) == 0,
+        "flux_plugin_add_handler (p, 'op.add', NULL) removes handler");
+    ok (flux_plugin_match_handler (p, "op.add") == NULL,
+        "flux_plugin_match_handler (p, 'op.add') returns NULL after remove");
+
+    flux_plugin_destroy (p);
+}
+
 void test_register ()
 {
     const char *fn;
@@ -532,6 +570,7 @@ int main (int argc, char *argv[])
     test_invalid_args ();
     test_plugin_args ();
     test_basic ();
+    test_match_cache ();
     test_register ();
     test_load ();
     test_load_rtld_now ();
@@ -39,11 +39,19 @@
 #define MAX_HOST_SUFFIX 1<<25
 
 /* max number of ranges that will be processed between brackets */
-#define MAX_RANGES    10240    /* 10K Ranges */
+#define MAX_RANGES    1<<20    /* 1M Ranges */
+
+/* initial size of range scratch array used when parsing brackets */
+#define RANGES_CHUNK  64
 
 /* max size of internal hostrange buffer */
 #define MAXHOSTRANGELEN 1024
 
+/* minimum number of ranges before hostlist_find() and hostlist_nth()
+ * build a lookup index (below this a linear scan is cheaper)
+ */
+#define HOSTLIST_INDEX_MIN 64
+
 /* Helper structure for hostlist iteration
  */
 struct current {
@@ -52,6 +60,41 @@ struct current {
     int depth;
 };
 
+/* Lookup index for large hostlists, built on demand and discarded
+ *  whenever the range array is modified.
+ *
+ * Ranges are grouped by prefix (singlehost ranges, whose prefix is the
+ *  whole hostname, are grouped separately) and groups are located via
+ *  a hash table. Entries within a numeric group are sorted by 'lo' so
+ *  that the range containing a host can be found by binary search.
+ *  'offsets' holds the position of the first host of each range.
+ */
+struct index_entry {
+    unsigned long lo;
+    unsigned long hi;
+    unsigned long maxhi;    /* max 'hi' of this and all preceding entries */
+    int range;              /* index of range in hl->hr */
+};
+
+struct index_group {
+    const char *prefix;
+    int len_prefix;
+    int singlehost;
+    int start;              /* index of first entry in idx->entries */
+    int count;              /* number of entries in this group */
+    int next;               /* next group in same bucket or -1 */
+};
+
+struct hostlist_index {
+    unsigned int nbuckets;  /* number of buckets (power of 2) */
+    int *buckets;           /* first group in each bucket or -1 */
+    int ngroups;
+    struct index_group *groups;
+    struct index_entry *entries;
+    int *offsets;           /* host position of first host in each range */
+};
+
+
 /* Hostlist - a dynamic array of hostrange objects
  */
 struct hostlist {
@@ -61,6 +104,7 @@ struct hostlist {
     struct hostrange **hr;  /* pointer to hostrange array */
 
     struct current current; /* iterator cursor */
+    struct hostlist_index *index; /* find/nth index, NULL if not built */
 };
 
 /* _range struct helper for parsing hostlist strings
@@ -134,6 +178,157 @@ fail:
 }
 
 
+static void hostlist_index_destroy (struct hostlist_index *idx)
+{
+    if (idx) {
+        free (idx->buckets);
+        free (idx->groups);
+        free (idx->entries);
+        free (idx->offsets);
+        free (idx);
+    }
+}
+
+/* Discard the lookup index. Must be called by anything that modifies
+ *  the range array or the ranges it contains.
+ */
+static inline void hostlist_index_reset (struct hostlist *hl)
+{
+    if (hl->index) {
+        hostlist_index_destroy (hl->index);
+        hl->index = NULL;
+    }
+}
+
+/* FNV-1a */
+static unsigned int prefix_hash (const char *s, int len)
+{
+    unsigned int h = 2166136261u;
+    for (int i = 0; i < len; i++) {
+        h ^= (unsigned char) s[i];
+        h *= 16777619u;
+    }
+    return h;
+}
+
+static int hostlist_index_group (struct hostlist_index *idx,
+                                 const char *prefix,
+                                 int len,
+                                 int singlehost)
+{
+    unsigned int b = prefix_hash (prefix, len) & (idx->nbuckets - 1);
+    for (int g = idx->buckets[b]; g >= 0; g = idx->groups[g].next) {
+        struct index_group *grp = &idx->groups[g];
+        if (grp->len_prefix == len
+            && grp->singlehost == singlehost
+            && memcmp (grp->prefix, prefix, len) == 0)
+            return g;
+    }
+    return -1;
+}
+
+static int hostlist_index_group_add (struct hostlist_index *idx,
+                                     struct hostrange *hr)
+{
+    unsigned int b = prefix_hash (hr->prefix, hr->len_prefix)
+                     & (idx->nbuckets - 1);
+    struct index_group *grp = &idx->groups[idx->ngroups];
+
+    grp->prefix = hr->prefix;
+    grp->len_prefix = hr->len_prefix;
+    grp->singlehost = hr->singlehost;
+    grp->start = 0;
+    grp->count = 0;
+    grp->next = idx->buckets[b];
+    idx->buckets[b] = idx->ngroups;
+    return idx->ngroups++;
+}
+
+static int entry_cmp (const void *a, const void *b)
+{
+    const struct index_entry *e1 = a;
+    const struct index_entry *e2 = b;
+    if (e1->lo != e2->lo)
+        return e1->lo < e2->lo ? -1 : 1;
+    return e1->range - e2->range;
+}
+
+static struct hostlist_index *hostlist_index_create (struct hostlist *hl)
+{
+    struct hostlist_index *idx;
+    int *group_of = NULL;
+    int count = 0;
+
+    if (!(idx = calloc (1, sizeof (*idx))))
+        return NULL;
+    idx->nbuckets = 1;
+    while (idx->nbuckets < hl->nranges)
+        idx->nbuckets <<= 1;
+    if (!(idx->buckets = malloc (idx->nbuckets * sizeof (int)))
+        || !(idx->groups = malloc (hl->nranges * sizeof (*idx->groups)))
+        || !(idx->entries = malloc (hl->nranges * sizeof (*idx->entries)))
+        || !(idx->offsets = malloc (hl->nranges * sizeof (int)))
+        || !(group_of = malloc (hl->nranges * sizeof (int)))) {
+        hostlist_index_destroy (idx);
+        return NULL;
+    }
+    memset (idx->buckets, 0xff, idx->nbuckets * sizeof (int));
+
+    /*  Assign each range to a group and compute host offsets
+     */
+    for (int i = 0; i < hl->nranges; i++) {
+        struct hostrange *hr = hl->hr[i];
+        int g = hostlist_index_group (idx,
+                                      hr->prefix,
+                                      hr->len_prefix,
+                                      hr->singlehost);
+        if (g < 0)
+            g = hostlist_index_group_add (idx, hr);
+        idx->groups[g].count++;
+        group_of[i] = g;
+        idx->offsets[i] = count;
+        count += hostrange_count (hr);
+    }
+    for (int g = 0, start = 0; g < idx->ngroups; g++) {
+        idx->groups[g].start = start;
+        start += idx->groups[g].count;
+        idx->groups[g].count = 0;
+    }
+    for (int i = 0; i < hl->nranges; i++) {
+        struct index_group *grp = &idx->groups[group_of[i]];
+        struct index_entry *e = &idx->entries[grp->start + grp->count++];
+        e->lo = hl->hr[i]->lo;
+        e->hi = hl->hr[i]->hi;
+        e->range = i;
+    }
+    free (group_of);
+
+    /*  Sort numeric groups by lo. Singlehost groups remain in range order.
+     */
+    for (int g = 0; g < idx->ngroups; g++) {
+        struct index_group *grp = &idx->groups[g];
+        struct index_entry *e = &idx->entries[grp->start];
+        if (grp->singlehost)
+            continue;
+        qsort (e, grp->count, sizeof (*e), entry_cmp);
+        for (int i = 0; i < grp->count; i++)
+            e[i].maxhi = i > 0 && e[i-1].maxhi > e[i].hi ?
+                         e[i-1].maxhi : e[i].hi;
+    }
+    return idx;
+}
+
+/* Return the lookup index for hl, building it if necessary.
+ * Returns NULL if hl is too small to benefit from an index, or
+ *  the index could not be allocated.
+ */
+static struct hostlist_index *hostlist_index_get (struct hostlist *hl)
+{
+    if (!hl->index && hl->nranges >= HOSTLIST_INDEX_MIN)
+        hl->index = hostlist_index_create (hl);
+    return hl->index;
+}
+
 /* Resize the internal array used to store the list of hostrange objects.
  *
  * returns 1 for a successful resize,
@@ -158,12 +353,15 @@ static int hostlist_resize (struct hostlist *hl, size_t newsize)
     return 1;
 }
 
-/* Resize hostlist by one HOSTLIST_CHUNK
+/* Grow hostlist geometrically (by at least one HOSTLIST_CHUNK) so that
+ * appending many uncompressible hosts does not realloc on every chunk.
  * Assumes that hostlist hl is locked by caller
  */
 static int hostlist_expand (struct hostlist *hl)
 {
-    if (!hostlist_resize (hl, hl->size + HOSTLIST_CHUNK))
+    size_t newsize = hl->size < HOSTLIST_CHUNK ?
+                     hl->size + HOSTLIST_CHUNK : hl->size * 2;
+    if (!hostlist_resize (hl, newsize))
         return 0;
     else
         return 1;
@@ -180,6 +378,8 @@ static int hostlist_append_range (struct hostlist *hl, struct hostrange * hr)
 
     assert (hr != NULL);
 
+    hostlist_index_reset (hl);
+
     tail = (hl->nranges > 0) ? hl->hr[hl->nranges-1] : hl->hr[0];
 
     if (hl->size == hl->nranges && !hostlist_expand (hl))
@@ -205,7 +405,8 @@ static int hostlist_append_range (struct hostlist *hl, struct hostrange * hr)
 
 
 /* Same as hostlist_append_range() above, but prefix, lo, hi, and width
- * are passed as args
+ * are passed as args. A temporary hostrange on the stack is used since
+ * hostlist_append_range() only copies hr when it can't extend the tail.
  */
 static int hostlist_append_hr (struct hostlist *hl,
                                char *prefix,
@@ -213,13 +414,18 @@ static int hostlist_append_hr (struct hostlist *hl,
                                unsigned long hi,
                                int width)
 {
-    int retval;
-    struct hostrange * hr = hostrange_create (prefix, lo, hi, width);
-    if (!hr)
+    struct hostrange hr = {
+        .prefix = prefix,
+        .len_prefix = strlen (prefix),
+        .lo = lo,
+        .hi = hi,
+        .width = width,
+    };
+    if (lo > hi || width < 0) {
+        errno = EINVAL;
         return -1;
-    retval = hostlist_append_range (hl, hr);
-    hostrange_destroy (hr);
-    return retval;
+    }
+    return hostlist_append_range (hl, &hr);
 }
 
 /* Insert a range object hr into position n of the hostlist hl
@@ -237,6 +443,8 @@ static int hostlist_insert_range (struct hostlist *hl,
     if (n > hl->nranges)
         return 0;
 
+    hostlist_index_reset (hl);
+
     if (hl->size == hl->nranges && !hostlist_expand (hl))
         return 0;
 
@@ -310,6 +518,8 @@ static void hostlist_delete_range (struct hostlist *hl, int n)
     assert (hl != NULL);
     assert (n < hl->nranges && n >= 0);
 
+    hostlist_index_reset (hl);
+
     old = hl->hr[n];
     for (i = n; i < hl->nranges - 1; i++)
         hl->hr[i] = hl->hr[i + 1];
@@ -375,54 +585,75 @@ static int parse_next_range (const char *str, struct _range *range)
     return -1;
 }
 
+/* Append a single host. The hostname is parsed in place and a
+ * temporary hostrange on the stack is used, so nothing is allocated
+ * unless a new range has to be added to hl.
+ */
 static int hostlist_append_host (struct hostlist *hl, const char *str)
 {
-    int rc = -1;
-    struct hostrange * hr;
-    struct hostlist_hostname * hn;
+    struct stack_hostname hn_storage;
+    struct stack_hostname *hn;
+    struct hostrange hr = { 0 };
 
     assert (hl != NULL);
 
     if (str == NULL || *str == '\0')
         return 0;
 
-    if (!(hn = hostname_create (str)))
+    errno = 0;
+    if (!(hn = hostname_stack_create (&hn_storage, str)))
+        return -1;
+    if (errno == ERANGE)
         return -1;
 
-    if (hostname_suffix_is_valid (hn)) {
-        hr = hostrange_create (hn->prefix,
-                               hn->num,
-                               hn->num,
-                               hostname_suffix_width (hn));
-    } else
-        hr = hostrange_create_single (str);
-
-    if (hr && hostlist_append_range (hl, hr) >= 0)
-        rc = 0;
-
-    hostrange_destroy (hr);
-    hostname_destroy (hn);
-
-    return rc;
+    char prefix[hn->len_prefix + 1];
+    if (hn->suffix) {
+        memcpy (prefix, str, hn->len_prefix);
+        prefix[hn->len_prefix] = '\0';
+        hr.prefix = prefix;
+        hr.len_prefix = hn->len_prefix;
+        hr.lo = hr.hi = hn->num;
+        hr.width = hn->width;
+    }
+    else {
+        hr.prefix = (char *) str;
+        hr.len_prefix = hn->len;
+        hr.singlehost = 1;
+    }
+    if (hostlist_append_range (hl, &hr) < 0)
+        return -1;
+    return 0;
 }
 
 /*
  * Convert 'str' containing comma separated digits and ranges into an array
- *  of struct _range types (max 'len' elements).
+ *  of struct _range types (max MAX_RANGES elements). The array in *rangesp
+ *  (of current size *sizep) is grown as necessary and may be reused by the
+ *  caller for subsequent calls.
  *
  * Return number of ranges created, or -1 on error.
  */
-static int parse_range_list (char *str, struct _range *ranges, int len)
+static int parse_range_list (char *str, struct _range **rangesp, int *sizep)
 {
     char *p;
     int count = 0;
 
     while (str) {
-        if (count == len)
-            return -1;
+        if (count == *sizep) {
+            struct _range *new;
+            int size = *sizep ? *sizep * 2 : RANGES_CHUNK;
+            if (count == MAX_RANGES)
+                return -1;
+            if (size > MAX_RANGES)
+                size = MAX_RANGES;
+            if (!(new = realloc (*rangesp, size * sizeof (*new))))
+                return -1;
+            *rangesp = new;
+            *sizep = size;
+        }
         if ((p = strchr (str, ',')))
             *p++ = '\0';
-        if (parse_next_range (str, &ranges[count++]) < 0)
+        if (parse_next_range (str, &(*rangesp)[count++]) < 0)
             return -1;
         str = p;
     }
@@ -459,21 +690,19 @@ static int append_range_list_with_suffix (struct hostlist *hl,
     for (i = 0; i < n; i++) {
         for (j = rng->lo; j <= rng->hi; j++) {
             char host[size];
-            struct hostrange * hr;
-            snprintf (host,
-                      sizeof (host),
-                      "%s%0*lu%s",
-                      pfx,
-                      rng->width,
-                      j,
-                      sfx);
-            if (!(hr = hostrange_create_single (host)))
-                return -1;
-            hostlist_append_range (hl, hr);
+            struct hostrange hr = { .prefix = host, .singlehost = 1 };
+            hr.len_prefix = snprintf (host,
+                                      sizeof (host),
+                                      "%s%0*lu%s",
+                                      pfx,
+                                      rng->width,
+                                      j,
+                                      sfx);
             /*
-             * hr is copied in hostlist_append_range. Need to free here.
+             * hr is copied in hostlist_append_range if necessary.
              */
-            hostrange_destroy (hr);
+            if (hostlist_append_range (hl, &hr) < 0)
+                return -1;
         }
         rng++;
     }
@@ -488,10 +717,8 @@ static struct hostlist * hostlist_create_bracketed (const char *hostlist,
                                                     char *r_op)
 {
     struct hostlist * new = hostlist_create ();
-    struct {
-        struct _range ranges[MAX_RANGES];
-        char cur_tok[1024];
-    } *ctx;
+    struct _range *ranges = NULL;
+    int nranges = 0;
     int nr;
     int rc;
     char *p, *tok, *str, *orig;
@@ -502,23 +729,19 @@ static struct hostlist * hostlist_create_bracketed (const char *hostlist,
     if (hostlist == NULL)
         return new;
 
-    if (!(orig = str = strdup (hostlist))
-        || !(ctx = calloc (1, sizeof (*ctx)))) {
+    if (!(orig = str = strdup (hostlist))) {
         hostlist_destroy (new);
-        ERRNO_SAFE_WRAP (free, orig);
         return NULL;
     }
 
     while ((tok = next_tok (sep, &str)) != NULL) {
-        strncpy (ctx->cur_tok, tok, 1024 - 1);
-
         if ((p = strchr (tok, '[')) != NULL) {
             char *q, *prefix = tok;
             *p++ = '\0';
 
             if ((q = strchr (p, ']'))) {
                 *q = '\0';
-                nr = parse_range_list (p, ctx->ranges, MAX_RANGES);
+                nr = parse_range_list (p, &ranges, &nranges);
                 if (nr < 0)
                     goto error;
 
@@ -526,12 +749,12 @@ static struct hostlist * hostlist_create_bracketed (const char *hostlist,
                     rc = append_range_list_with_suffix (new,
                                                         prefix,
                                                         q,
-                                                        ctx->ranges,
+                                                        ranges,
                                                         nr);
                 else
                     rc = append_range_list (new,
                                             prefix,
-                                            ctx->ranges,
+                                            ranges,
                                             nr);
                 if (rc < 0)
                     goto error;
@@ -542,11 +765,11 @@ static struct hostlist * hostlist_create_bracketed (const char *hostlist,
         } else if (strchr (tok, ']')) /* Error: brackets must be balanced */
             goto error_unmatched;
         else                          /* Ok: No brackets found, single host */
-            hostlist_append_host (new, ctx->cur_tok);
+            hostlist_append_host (new, tok);
     }
 
     free (orig);
-    free (ctx);
+    free (ranges);
     return new;
 
   error_unmatched:
@@ -554,7 +777,7 @@ static struct hostlist * hostlist_create_bracketed (const char *hostlist,
   error:
     hostlist_destroy (new);
     ERRNO_SAFE_WRAP (free, orig);
-    ERRNO_SAFE_WRAP (free, ctx);
+    ERRNO_SAFE_WRAP (free, ranges);
     return NULL;
 }
 
@@ -599,6 +822,7 @@ void hostlist_destroy (struct hostlist *hl)
             hostrange_destroy (hl->hr[i]);
         free (hl->hr);
         free (hl->current.host);
+        hostlist_index_destroy (hl->index);
         free (hl);
         errno = saved_errno;
     }
@@ -614,6 +838,16 @@ int hostlist_append (struct hostlist *hl, const char *hosts)
     }
     if (hosts == NULL)
         return 0;
+    /*  Fast path: a single hostname can be appended directly without
+     *   decoding into a temporary hostlist.
+     */
+    if (hosts[strcspn (hosts, "[]\t, ")] == '\0') {
+        if (*hosts == '\0')
+            return 0;
+        if (hostlist_append_host (hl, hosts) < 0)
+            return -1;
+        return 1;
+    }
     new = hostlist_decode (hosts);
     if (!new)
         return -1;
@@ -661,13 +895,39 @@ static void set_current (struct current *cur, int index, int depth)
     }
 }
 
+/* Return the index of the range containing host position n using
+ * a binary search of the index offsets array.
+ */
+static int hostlist_index_nth (struct hostlist *hl,
+                               struct hostlist_index *idx,
+                               int n)
+{
+    int lo = 0;
+    int hi = hl->nranges - 1;
+    while (lo < hi) {
+        int mid = lo + (hi - lo + 1) / 2;
+        if (idx->offsets[mid] <= n)
+            lo = mid;
+        else
+            hi = mid - 1;
+    }
+    return lo;
+}
+
 const char * hostlist_nth (struct hostlist *hl, int n)
 {
     int   i, count;
+    struct hostlist_index *idx;
 
     if (nth_args_valid (hl, n) < 0)
         return NULL;
 
+    if ((idx = hostlist_index_get (hl))) {
+        i = hostlist_index_nth (hl, idx, n);
+        set_current (&hl->current, i, n - idx->offsets[i]);
+        return hostlist_current (hl);
+    }
+
     count = 0;
     for (i = 0; i < hl->nranges; i++) {
         int num_in_range = hostrange_count (hl->hr[i]);
@@ -687,11 +947,106 @@ int hostlist_count (struct hostlist *hl)
     return hl ? hl->nhosts : 0;
 }
 
+/* Search group g of the lookup index for hn, updating *found and *depth
+ *  if a range with index lower than *found contains the host. 'num' is
+ *  the numeric suffix of hn relative to the group prefix.
+ */
+static void hostlist_index_group_find (struct hostlist *hl,
+                                       struct hostlist_index *idx,
+                                       int g,
+                                       struct stack_hostname *hn,
+                                       unsigned long num,
+                                       int *found,
+                                       int *depth)
+{
+    struct index_group *grp = &idx->groups[g];
+    struct index_entry *e = &idx->entries[grp->start];
+    int lo = 0;
+    int hi = grp->count - 1;
+    int offset;
+
+    if (grp->singlehost) {
+        for (int i = 0; i < grp->count && e[i].range < *found; i++) {
+            if ((offset = hostrange_hn_within (hl->hr[e[i].range], hn)) >= 0) {
+                *found = e[i].range;
+                *depth = offset;
+                return;
+            }
+        }
+        return;
+    }
+
+    /*  Find the last entry with lo <= num, then walk back while an
+     *   earlier entry could still contain num (only possible when
+     *   ranges overlap) to find the lowest matching range index.
+     */
+    if (grp->count == 0 || e[0].lo > num)
+        return;
+    while (lo < hi) {
+        int mid = lo + (hi - lo + 1) / 2;
+        if (e[mid].lo <= num)
+            lo = mid;
+        else
+            hi = mid - 1;
+    }
+    for (int i = lo; i >= 0 && e[i].maxhi >= num; i--) {
+        if (e[i].hi >= num
+            && e[i].range < *found
+            && (offset = hostrange_hn_within (hl->hr[e[i].range], hn)) >= 0) {
+            *found = e[i].range;
+            *depth = offset;
+        }
+    }
+}
+
+/* Indexed version of hostlist_find_host().
+ *
+ * A range can only contain hn if its prefix is hn->hostname truncated
+ *  somewhere between the start of the numeric suffix and the end of the
+ *  name (see hostrange_hn_within()), so only the groups for those
+ *  prefixes need to be searched. The lowest matching range index wins,
+ *  as with the linear scan.
+ */
+static int hostlist_index_find (struct hostlist *hl,
+                                struct hostlist_index *idx,
+                                struct stack_hostname *hn,
+                                struct current *cur)
+{
+    int found = hl->nranges;
+    int depth = -1;
+
+    for (int len = hn->len_prefix; len <= hn->len; len++) {
+        int singlehost = len == hn->len;
+        unsigned long num = 0;
+        int g;
+
+        if ((g = hostlist_index_group (idx,
+                                       hn->hostname,
+                                       len,
+                                       singlehost)) < 0)
+            continue;
+        if (!singlehost)
+            num = strtoul (hn->hostname + len, NULL, 10);
+        hostlist_index_group_find (hl, idx, g, hn, num, &found, &depth);
+    }
+    if (found == hl->nranges) {
+        errno = ENOENT;
+        return -1;
+    }
+    set_current (cur, found, depth);
+    return idx->offsets[found] + depth;
+}
+
 static int hostlist_find_host (struct hostlist *hl,
                                struct stack_hostname *hn,
                                struct current *cur)
 {
     int i, count, ret = -1;
+    struct hostlist_index *idx;
+
+    if ((idx = hostlist_index_get (hl)))
+        return hostlist_index_find (hl, idx, hn, cur);
+
     for (i = 0, count = 0; i < hl->nranges; i++) {
         int offset = hostrange_hn_within (hl->hr[i], hn);
         if (offset >= 0) {
@@ -760,6 +1115,8 @@ static int hostlist_remove_at (struct hostlist *hl, struct current *cur)
     if (cur->index > hl->nhosts - 1)
         return 0;
 
+    hostlist_index_reset (hl);
+
     hr = hl->hr[cur->index];
 
     /*  If we're removing the current host, invalidate cursor hostname
@@ -958,6 +1315,7 @@ void hostlist_sort (struct hostlist *hl)
         return;
     if (hl->nranges <= 1)
         return;
+    hostlist_index_reset (hl);
     qsort (hl->hr, hl->nranges, sizeof (struct hostrange *), _cmp);
     hostlist_coalesce (hl);
 }
@@ -989,6 +1347,7 @@ void hostlist_uniq (struct hostlist *hl)
     if (hl->nranges <= 1)
         return;
 
+    hostlist_index_reset (hl);
     qsort (hl->hr, hl->nranges, sizeof (struct hostrange *), &_cmp);
 
     while (i < hl->nranges) {
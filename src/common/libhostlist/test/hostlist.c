@@ -14,6 +14,7 @@
 
 #include <string.h>
 #include <errno.h>
+#include <time.h>
 
 #include "src/common/libtap/tap.h"
 #include "src/common/libhostlist/hostlist.h"
@@ -371,6 +372,128 @@ void test_find_hostname ()
     }
 }
 
+/*  Repeat find tests with enough leading ranges that hostlist_find()
+ *   uses the hashed index instead of a linear scan.
+ */
+void test_find_indexed ()
+{
+    struct find_test *t = find_tests;
+    char pad[1024];
+    int npad = 128;
+    int n = 0;
+
+    n = snprintf (pad, sizeof (pad), "pad[0");
+    for (int i = 1; i < npad; i++)
+        n += snprintf (pad + n, sizeof (pad) - n, ",%d", i * 2);
+    snprintf (pad + n, sizeof (pad) - n, "]");
+
+    while (t && t->input) {
+        int rc;
+        int expected = t->rc >= 0 ? t->rc + npad : t->rc;
+        struct hostlist *hl = hostlist_decode (pad);
+        if (!hl || hostlist_append (hl, t->input) < 0)
+            BAIL_OUT ("hostlist_decode (%s) failed!", t->input);
+        rc = hostlist_find (hl, t->arg);
+        ok (rc == expected,
+            "indexed hostlist_find ('%s', '%s') returned %d",
+            t->input, t->arg, rc);
+        if (t->rc >= 0)
+            is (hostlist_current (hl), t->arg,
+                "indexed hostlist_find leaves cursor pointing to found host");
+        hostlist_destroy (hl);
+        t++;
+    }
+}
+
+static double elapsed (struct timespec *t0)
+{
+    struct timespec t1;
+    clock_gettime (CLOCK_MONOTONIC, &t1);
+    return (t1.tv_sec - t0->tv_sec) + (t1.tv_nsec - t0->tv_nsec) * 1E-9;
+}
+
+/*  Build, search, and encode a large hostlist that does not compress
+ *   into ranges.  The time taken by each step is reported with diag().
+ */
+static void test_large ()
+{
+    int count = 50000;
+    struct hostlist *hl;
+    struct hostlist *hl2;
+    struct timespec t0;
+    char host[64];
+    char *s;
+    int errors;
+
+    if (!(hl = hostlist_create ()))
+        BAIL_OUT ("hostlist_create");
+
+    clock_gettime (CLOCK_MONOTONIC, &t0);
+    for (int i = 0; i < count; i++) {
+        snprintf (host, sizeof (host), "node%d", i * 2);
+        if (hostlist_append (hl, host) != 1)
+            BAIL_OUT ("hostlist_append %s failed", host);
+    }
+    diag ("hostlist_append of %d hosts took %.3fs", count, elapsed (&t0));
+    ok (hostlist_count (hl) == count,
+        "appended %d hosts one at a time",
+        count);
+
+    errors = 0;
+    clock_gettime (CLOCK_MONOTONIC, &t0);
+    for (int i = count - 1; i >= 0; i--) {
+        snprintf (host, sizeof (host), "node%d", i * 2);
+        if (hostlist_find (hl, host) != i)
+            errors++;
+    }
+    diag ("hostlist_find of %d hosts took %.3fs", count, elapsed (&t0));
+    ok (errors == 0,
+        "hostlist_find finds each of %d hosts",
+        count);
+    ok (hostlist_find (hl, "node1") < 0 && errno == ENOENT,
+        "hostlist_find of missing host fails with ENOENT");
+
+    errors = 0;
+    clock_gettime (CLOCK_MONOTONIC, &t0);
+    for (int i = count - 1; i >= 0; i--) {
+        const char *name = hostlist_nth (hl, i);
+        snprintf (host, sizeof (host), "node%d", i * 2);
+        if (!name || strcmp (name, host) != 0)
+            errors++;
+    }
+    diag ("hostlist_nth of %d hosts took %.3fs", count, elapsed (&t0));
+    ok (errors == 0,
+        "hostlist_nth returns each of %d hosts",
+        count);
+
+    clock_gettime (CLOCK_MONOTONIC, &t0);
+    s = hostlist_encode (hl);
+    diag ("hostlist_encode of %d hosts took %.3fs", count, elapsed (&t0));
+    ok (s != NULL,
+        "hostlist_encode of %d hosts works",
+        count);
+
+    clock_gettime (CLOCK_MONOTONIC, &t0);
+    hl2 = hostlist_decode (s);
+    diag ("hostlist_decode of %d hosts took %.3fs", count, elapsed (&t0));
+    ok (hl2 != NULL && hostlist_count (hl2) == count,
+        "hostlist_decode of %d hosts works",
+        count);
+    free (s);
+    hostlist_destroy (hl2);
+
+    ok (hostlist_delete (hl, "node0") == 1,
+        "hostlist_delete works on large hostlist");
+    ok (hostlist_find (hl, "node0") < 0 && errno == ENOENT,
+        "hostlist_find no longer finds deleted host");
+    ok (hostlist_find (hl, "node2") == 0,
+        "hostlist_find reflects updated positions after delete");
+    ok (hostlist_append (hl, "node0") == 1
+        && hostlist_find (hl, "node0") == count - 1,
+        "hostlist_find reflects appended host");
+
+    hostlist_destroy (hl);
+}
 
 struct delete_test {
     char *input;
@@ -646,11 +769,13 @@ int main (int argc, char *argv[])
     test_nth ();
     test_find ();
     test_find_hostname ();
+    test_find_indexed ();
     test_delete ();
     test_sortuniq ();
     test_iteration ();
     test_iteration_with_delete ();
     test_encode_large ();
+    test_large ();
 
     done_testing ();
 }
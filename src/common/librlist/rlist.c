@@ -1491,21 +1491,39 @@ fail:
     return NULL;
 }
 
-static int rlist_idset_set_by_host (const struct rlist *rl,
-                                    struct idset *ids,
-                                    const char *host)
+/*  Return a hash of hostname -> idset of ranks for all nodes in rl,
+ *   so that many hosts can be mapped to ranks with a single pass over
+ *   the node list.
+ */
+static zhashx_t *rlist_host_index (const struct rlist *rl)
 {
-    int count = 0;
-    struct rnode *n = zlistx_first (rl->nodes);
+    struct rnode *n;
+    zhashx_t *hosts = zhashx_new ();
+
+    if (!hosts) {
+        errno = ENOMEM;
+        return NULL;
+    }
+    zhashx_set_destructor (hosts, property_destructor);
+
+    n = zlistx_first (rl->nodes);
     while (n) {
-        if (n->hostname && streq (n->hostname, host)) {
-            if (idset_set (ids, n->rank) < 0)
-                return -1;
-            count++;
+        if (n->hostname) {
+            struct idset *ranks = zhashx_lookup (hosts, n->hostname);
+            if (!ranks) {
+                if (!(ranks = idset_create (0, IDSET_FLAG_AUTOGROW)))
+                    goto error;
+                (void) zhashx_insert (hosts, n->hostname, ranks);
+            }
+            if (idset_set (ranks, n->rank) < 0)
+                goto error;
         }
         n = zlistx_next (rl->nodes);
     }
-    return count;
+    return hosts;
+error:
+    zhashx_destroy (&hosts);
+    return NULL;
 }
 
 struct idset *rlist_hosts_to_ranks (const struct rlist *rl,
@@ -1516,6 +1534,7 @@ struct idset *rlist_hosts_to_ranks (const struct rlist *rl,
     struct idset *ids = NULL;
     struct hostlist *hl = NULL;
     struct hostlist *missing = NULL;
+    zhashx_t *index = NULL;
 
     if (errp)
         memset (errp->text, 0, sizeof (errp->text));
@@ -1537,16 +1556,20 @@ struct idset *rlist_hosts_to_ranks (const struct rlist *rl,
         errprintf (errp, "hostlist_create: %s", strerror (errno));
         goto fail;
     }
+    if (!(index = rlist_host_index (rl))) {
+        errprintf (errp, "failed to index hostnames: %s", strerror (errno));
+        goto fail;
+    }
     host = hostlist_first (hl);
     while (host) {
-        int count = rlist_idset_set_by_host (rl, ids, host);
-        if (count < 0) {
+        struct idset *ranks = zhashx_lookup (index, host);
+        if (ranks && idset_add (ids, ranks) < 0) {
             errprintf (errp,
                         "error adding host %s to idset: %s",
                         host,
                         strerror (errno));
             goto fail;
-        } else if (!count && hostlist_append (missing, host) < 0) {
+        } else if (!ranks && hostlist_append (missing, host) < 0) {
             errprintf (errp,
                         "failed to append missing host '%s'",
                         host);
@@ -1562,10 +1585,12 @@ struct idset *rlist_hosts_to_ranks (const struct rlist *rl,
     }
     hostlist_destroy (hl);
     hostlist_destroy (missing);
+    zhashx_destroy (&index);
     return ids;
 fail:
     hostlist_destroy (hl);
     hostlist_destroy (missing);
+    zhashx_destroy (&index);
     idset_destroy (ids);
     return NULL;
 }
@@ -1761,35 +1786,113 @@ char *rlist_encode (const struct rlist *rl)
     return R;
 }
 
-static int by_rank (const void *item1, const void *item2)
+/*  Dense snapshot of the per-node state consulted by the allocation
+ *   sort and scan loops. Sorting and scanning an array of these avoids
+ *   chasing rnode -> rnode_child -> idset pointers on every comparison.
+ */
+struct rnode_key {
+    uint32_t rank;
+    bool up;
+    int avail;
+    struct rnode *n;
+    void *handle;
+};
+
+static void rnode_key_init (struct rnode_key *key, const struct rnode *n)
 {
-    const struct rnode *x = item1;
-    const struct rnode *y = item2;
+    key->rank = n->rank;
+    key->up = n->up;
+    key->avail = rnode_avail (n);
+    key->n = (struct rnode *) n;
+    key->handle = NULL;
+}
+
+static int key_by_rank (const void *item1, const void *item2)
+{
+    const struct rnode_key *x = item1;
+    const struct rnode_key *y = item2;
     return (x->rank - y->rank);
 }
 
-static int by_avail (const void *item1, const void *item2)
+static int key_by_avail (const void *item1, const void *item2)
 {
     int n;
-    const struct rnode *x = item1;
-    const struct rnode *y = item2;
-    if ((n = rnode_avail (x) - rnode_avail (y)) == 0)
-        n = by_rank (x, y);
+    const struct rnode_key *x = item1;
+    const struct rnode_key *y = item2;
+    if ((n = x->avail - y->avail) == 0)
+        n = key_by_rank (x, y);
     return n;
 }
 
-static int by_used (const void *item1, const void *item2)
+static int key_by_used (const void *item1, const void *item2)
 {
     int n;
-    const struct rnode *x = item1;
-    const struct rnode *y = item2;
+    const struct rnode_key *x = item1;
+    const struct rnode_key *y = item2;
     if (x->up != y->up)
         n = x->up ? -1 : 1;
-    else if ((n = rnode_avail (y) - rnode_avail (x)) == 0)
-        n = by_rank (x, y);
+    else if ((n = y->avail - x->avail) == 0)
+        n = key_by_rank (x, y);
     return n;
 }
 
+static int by_rank (const void *item1, const void *item2)
+{
+    const struct rnode *x = item1;
+    const struct rnode *y = item2;
+    return (x->rank - y->rank);
+}
+
+static int by_used (const void *item1, const void *item2)
+{
+    struct rnode_key x;
+    struct rnode_key y;
+    rnode_key_init (&x, item1);
+    rnode_key_init (&y, item2);
+    return key_by_used (&x, &y);
+}
+
+/*  Return an array of keys for all nodes in rl->nodes sorted by 'cmp'.
+ *   The number of entries is returned in 'countp'.
+ */
+static struct rnode_key *rlist_node_keys (struct rlist *rl,
+                                          zlistx_comparator_fn cmp,
+                                          size_t *countp)
+{
+    struct rnode_key *keys;
+    struct rnode *n;
+    size_t count = 0;
+
+    if (!(keys = calloc (zlistx_size (rl->nodes) + 1, sizeof (*keys))))
+        return NULL;
+    n = zlistx_first (rl->nodes);
+    while (n) {
+        rnode_key_init (&keys[count], n);
+        keys[count].handle = zlistx_cursor (rl->nodes);
+        count++;
+        n = zlistx_next (rl->nodes);
+    }
+    qsort (keys, count, sizeof (*keys), cmp);
+    *countp = count;
+    return keys;
+}
+
+/*  Sort rl->nodes by 'cmp' via a dense array of keys instead of
+ *   zlistx_sort(3), which compares linked list items in place.
+ */
+static int rlist_sort_nodes (struct rlist *rl, zlistx_comparator_fn cmp)
+{
+    struct rnode_key *keys;
+    size_t count;
+
+    if (!(keys = rlist_node_keys (rl, cmp, &count)))
+        return -1;
+    for (size_t i = 0; i < count; i++)
+        zlistx_move_end (rl->nodes, keys[i].handle);
+    free (keys);
+    return 0;
+}
+
 static int rlist_rnode_alloc (struct rlist *rl, struct rnode *n,
                               int count, struct idset **idsetp)
 {
@@ -1810,53 +1913,59 @@ static uint32_t rlist_rnode_rank (struct rlist *rl)
 }
 #endif
 
-static struct rnode *rlist_first (struct rlist *rl)
-{
-    return zlistx_first (rl->nodes);
-}
-
-static struct rnode *rlist_next (struct rlist *rl)
-{
-    return zlistx_next (rl->nodes);
-}
-
 /*
  *  Allocate the first available N slots of size cores_per_slot from
- *   resource list rl after sorting the nodes with the current sort strategy.
+ *   resource list rl after sorting the nodes with comparator 'cmp'.
  */
 static struct rlist * rlist_alloc_first_fit (struct rlist *rl,
+                                             zlistx_comparator_fn cmp,
                                              int cores_per_slot,
                                              int slots)
 {
     int rc;
     struct idset *ids = NULL;
-    struct rnode *n = NULL;
+    struct rnode_key *keys;
+    size_t count;
+    size_t i = 0;
     struct rlist *result = NULL;
 
-    zlistx_sort (rl->nodes);
-
-    if (!(n = rlist_first (rl)))
+    if (!(keys = rlist_node_keys (rl, cmp, &count)))
         return NULL;
-
-    if (!(result = rlist_create ()))
+    if (count == 0 || !(result = rlist_create ())) {
+        free (keys);
         return NULL;
+    }
 
     /* 2. assign slots to first nodes where they fit
      */
-    while (n && slots) {
+    while (i < count && slots) {
+        struct rnode_key *key = &keys[i];
+
+        /*  Skip nodes without enough free cores without touching
+         *   the rnode itself (equivalent to ENOSPC from rnode_alloc())
+         */
+        if (key->up && key->avail < cores_per_slot) {
+            i++;
+            continue;
+        }
         /*  Try to allocate a slot on this node. If we fail with ENOSPC,
          *   then advance to the next node and try again.
          */
-        if ((rc = rlist_rnode_alloc (rl, n, cores_per_slot, &ids)) < 0) {
+        if ((rc = rlist_rnode_alloc (rl,
+                                     key->n,
+                                     cores_per_slot,
+                                     &ids)) < 0) {
             if (errno != ENOSPC)
                 goto unwind;
-            n = rlist_next (rl);
+            i++;
             continue;
         }
+        key->avail -= cores_per_slot;
+
         /*  Append the allocated cores to the result set and continue
          *   if needed
          */
-        rc = rlist_append_cores (result, n->hostname, n->rank, ids);
+        rc = rlist_append_cores (result, key->n->hostname, key->n->rank, ids);
         idset_destroy (ids);
         if (rc < 0)
             goto unwind;
@@ -1864,11 +1973,13 @@ static struct rlist * rlist_alloc_first_fit (struct rlist *rl,
     }
     if (slots != 0) {
 unwind:
+        free (keys);
         rlist_free (rl, result);
         rlist_destroy (result);
         errno = ENOSPC;
         return NULL;
     }
+    free (keys);
     return result;
 }
 
@@ -1881,8 +1992,7 @@ static struct rlist * rlist_alloc_best_fit (struct rlist *rl,
                                             int cores_per_slot,
                                             int slots)
 {
-    zlistx_set_comparator (rl->nodes, by_avail);
-    return rlist_alloc_first_fit (rl, cores_per_slot, slots);
+    return rlist_alloc_first_fit (rl, key_by_avail, cores_per_slot, slots);
 }
 
 /*
@@ -1894,8 +2004,7 @@ static struct rlist * rlist_alloc_worst_fit (struct rlist *rl,
                                              int cores_per_slot,
                                              int slots)
 {
-    zlistx_set_comparator (rl->nodes, by_used);
-    return rlist_alloc_first_fit (rl, cores_per_slot, slots);
+    return rlist_alloc_first_fit (rl, key_by_used, cores_per_slot, slots);
 }
 
 
@@ -1949,8 +2058,8 @@ static struct rlist *rlist_alloc_nnodes (struct rlist *rl,
 
     /* 1. sort rank list by used cores ascending:
      */
-    zlistx_set_comparator (rl->nodes, by_used);
-    zlistx_sort (rl->nodes);
+    if (rlist_sort_nodes (rl, key_by_used) < 0)
+        goto unwind;
 
     if (ai->exclusive) {
         int nleft = ai->nnodes;
@@ -2052,7 +2161,10 @@ static struct rlist *rlist_try_alloc (struct rlist *rl,
     else if (mode && streq (mode, "best-fit"))
         result = rlist_alloc_best_fit (rl, ai->slot_size, ai->nslots);
     else if (mode && streq (mode, "first-fit"))
-        result = rlist_alloc_first_fit (rl, ai->slot_size, ai->nslots);
+        result = rlist_alloc_first_fit (rl,
+                                        key_by_rank,
+                                        ai->slot_size,
+                                        ai->nslots);
     else
         errno = EINVAL;
     return result;
@@ -25,6 +25,7 @@ typedef struct schedutil_ctx schedutil_t;
  */
 #define SCHEDUTIL_FREE_NOLOOKUP 1 // now the default so this flag is ignored
 #define SCHEDUTIL_HELLO_PARTIAL_OK 2
+#define SCHEDUTIL_FREE_BATCH 4 // accept batched sched.free requests
 
 /* Create a handle for the schedutil convenience library.
  *
@@ -45,15 +45,46 @@ static void cancel_cb (flux_t *h,
     util->ops->cancel (h, msg, util->cb_arg);
 }
 
+/* A batched sched.free request carries an array of RFC 27 free payloads
+ * under the "jobs" key.  Unpack each one into a standalone copy of the
+ * request so the scheduler's free callback sees the unbatched protocol.
+ */
+static void free_batch (schedutil_t *util,
+                        const flux_msg_t *msg,
+                        json_t *jobs)
+{
+    size_t index;
+    json_t *entry;
+
+    json_array_foreach (jobs, index, entry) {
+        flux_msg_t *cpy;
+
+        if (!(cpy = flux_msg_copy (msg, false))
+            || flux_msg_pack (cpy, "O", entry) < 0) {
+            flux_log_error (util->h, "sched.free: error unpacking batch");
+            flux_msg_destroy (cpy);
+            return;
+        }
+        util->ops->free (util->h, cpy, NULL, util->cb_arg);
+        flux_msg_destroy (cpy);
+    }
+}
+
 static void free_cb (flux_t *h,
                      flux_msg_handler_t *mh,
                      const flux_msg_t *msg,
                      void *arg)
 {
     schedutil_t *util = arg;
+    json_t *jobs;
 
     assert (util);
 
+    if ((util->flags & SCHEDUTIL_FREE_BATCH)
+        && flux_request_unpack (msg, NULL, "{s:o}", "jobs", &jobs) == 0) {
+        free_batch (util, msg, jobs);
+        return;
+    }
     util->ops->free (h, msg, NULL, util->cb_arg);
 }
 
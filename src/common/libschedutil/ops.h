@@ -45,6 +45,8 @@ struct schedutil_ops {
      * 'msg' is only valid for the duration of this call.
      * You should either respond to the request immediately (see
      * free.h), or cache this information for later response.
+     * If SCHEDUTIL_FREE_BATCH is set, batched requests from the job
+     * manager are split up and this callback is called once per job.
      */
     void (*free)(flux_t *h,
                  const flux_msg_t *msg,
@@ -24,6 +24,7 @@ int schedutil_ready (schedutil_t *util, const char *mode, int *queue_depth)
 {
     flux_future_t *f;
     int limit = 0;
+    int free_batch = 0;
     int count;
 
     if (!util || !mode) {
@@ -44,14 +45,17 @@ int schedutil_ready (schedutil_t *util, const char *mode, int *queue_depth)
         errno = EINVAL;
         return -1;
     }
+    if ((util->flags & SCHEDUTIL_FREE_BATCH))
+        free_batch = 1;
     if (limit) {
         if (!(f = flux_rpc_pack (util->h,
                                  "job-manager.sched-ready",
                                  FLUX_NODEID_ANY,
                                  0,
-                                 "{s:s s:i}",
+                                 "{s:s s:i s:b}",
                                  "mode", mode,
-                                 "limit", limit)))
+                                 "limit", limit,
+                                 "free-batch", free_batch)))
             return -1;
     }
     else {
@@ -59,8 +63,9 @@ int schedutil_ready (schedutil_t *util, const char *mode, int *queue_depth)
                                  "job-manager.sched-ready",
                                  FLUX_NODEID_ANY,
                                  0,
-                                 "{s:s}",
-                                 "mode", mode)))
+                                 "{s:s s:b}",
+                                 "mode", mode,
+                                 "free-batch", free_batch)))
             return -1;
     }
     if (flux_rpc_get_unpack (f, "{s:i}", "count", &count) < 0)
@@ -28,6 +28,9 @@ extern "C" {
  * 'queue_depth', if non-NULL, is set to the number of jobs in SCHED
  * state that have not yet requested resources.  Returns 0 on success,
  * -1 on failure with errno set.
+ *
+ * If the SCHEDUTIL_FREE_BATCH flag was passed to schedutil_create(),
+ * the job manager is told it may send sched.free requests in batches.
  */
 int schedutil_ready (schedutil_t *util, const char *mode, int *queue_depth);
 
@@ -13,6 +13,8 @@
 #endif
 
 #include <sys/wait.h>
+#include <stdlib.h>
+#include <stdio.h>
 #include "src/common/libmissing/macros.h"
 #define EXIT_CODE(x) __W_EXITCODE(x,0)
 
@@ -21,6 +23,7 @@
 
 #include "src/common/libczmqcontainers/czmq_containers.h"
 #include "src/common/libutil/aux.h"
+#include "src/common/libutil/kary.h"
 #include "src/common/libjob/idf58.h"
 #include "ccan/str/str.h"
 #include "bulk-exec.h"
@@ -29,6 +32,10 @@ struct exec_cmd {
     struct idset *ranks;
     flux_cmd_t *cmd;
     int flags;
+
+    uint32_t *order;         /* Launch order, or NULL for rank order */
+    int norder;
+    int next;
 };
 
 struct bulk_exec {
@@ -319,6 +326,7 @@ static void exec_cmd_destroy (void *arg)
         int saved_errno = errno;
         idset_destroy (cmd->ranks);
         flux_cmd_destroy (cmd->cmd);
+        free (cmd->order);
         free (cmd);
         errno = saved_errno;
     }
@@ -364,13 +372,56 @@ static int subprocess_destroy (flux_t *h, flux_subprocess_t *p)
     return 0;
 }
 
+/*  Return the next rank to start for 'cmd', or IDSET_INVALID_ID if
+ *   all ranks have been started.
+ */
+static uint32_t exec_cmd_next (struct exec_cmd *cmd)
+{
+    if (!cmd->order)
+        return idset_first (cmd->ranks);
+    while (cmd->next < cmd->norder) {
+        uint32_t rank = cmd->order[cmd->next];
+        if (idset_test (cmd->ranks, rank))
+            return rank;
+        cmd->next++;
+    }
+    return IDSET_INVALID_ID;
+}
+
+/*  Order ranks of 'cmd' round-robin across the TBON subtrees rooted at
+ *   the children of rank 0, so that when launches are paced by
+ *   max_start_per_loop, requests reach all subtrees early instead of
+ *   filling the routing brokers of one subtree at a time.
+ */
+static int exec_cmd_order (struct exec_cmd *cmd, int k, uint32_t size)
+{
+    int count = idset_count (cmd->ranks);
+    uint32_t rank;
+    int n = 0;
+
+    if (count <= 1)
+        return 0;
+    if (!(cmd->order = calloc (count, sizeof (cmd->order[0]))))
+        return -1;
+    rank = idset_first (cmd->ranks);
+    while (rank != IDSET_INVALID_ID && n < count) {
+        cmd->order[n++] = rank;
+        rank = idset_next (cmd->ranks, rank);
+    }
+    if (kary_interleave_subtrees (k, size, cmd->order, n) < 0)
+        return -1;
+    cmd->norder = n;
+    cmd->next = 0;
+    return 0;
+}
+
 static int exec_start_cmd (struct bulk_exec *exec,
                            struct exec_cmd *cmd,
                            int max)
 {
     int count = 0;
     uint32_t rank;
-    rank = idset_first (cmd->ranks);
+    rank = exec_cmd_next (cmd);
     while (rank != IDSET_INVALID_ID && (max < 0 || count < max)) {
         /* Set the unit name for the "sdexec" service.  This is done here
          * for each rank instead of once in bulk_exec_push_cmd() to ensure
@@ -422,7 +473,7 @@ static int exec_start_cmd (struct bulk_exec *exec,
                      true);
 
         idset_clear (cmd->ranks, rank);
-        rank = idset_next (cmd->ranks, rank);
+        rank = exec_cmd_next (cmd);
         count++;
     }
     return count;
@@ -580,6 +631,9 @@ int bulk_exec_push_cmd (struct bulk_exec *exec,
 int bulk_exec_start (flux_t *h, struct bulk_exec *exec)
 {
     flux_reactor_t *r;
+    struct exec_cmd *cmd;
+    uint32_t size;
+    int k;
 
     if (!h || !exec) {
         errno = EINVAL;
@@ -588,6 +642,16 @@ int bulk_exec_start (flux_t *h, struct bulk_exec *exec)
 
     r = flux_get_reactor (h);
     exec->h = h;
+
+    if ((k = kary_parse_topo (flux_attr_get (h, "tbon.topo"))) > 0
+        && flux_get_size (h, &size) == 0) {
+        cmd = zlist_first (exec->commands);
+        while (cmd) {
+            if (exec_cmd_order (cmd, k, size) < 0)
+                return -1;
+            cmd = zlist_next (exec->commands);
+        }
+    }
     exec->prep = flux_prepare_watcher_create (r, prep_cb, exec);
     exec->check = flux_check_watcher_create (r, check_cb, exec);
     exec->idle = flux_idle_watcher_create (r, NULL, NULL);
@@ -35,6 +35,11 @@
 #include "util.h"
 #include "sigchld.h"
 
+/* Max lines delivered to a line buffered output callback per
+ * reactor loop iteration.
+ */
+static const int local_output_batch = 128;
+
 static void local_channel_flush (struct subprocess_channel *c)
 {
     /* This is a full channel with read and write, a close on the
@@ -154,6 +159,25 @@ out:
     subprocess_decref (c->p);
 }
 
+static void local_output_drain (struct subprocess_channel *c,
+                                flux_watcher_t *w,
+                                flux_subprocess_output_f output_cb)
+{
+    struct fbuf *fb = fbuf_read_watcher_get_buffer (w);
+    int count = 1;
+
+    while (fb
+           && count++ < local_output_batch
+           && c->p->refcount > 1
+           && flux_watcher_is_active (w)
+           && fbuf_has_line (fb)) {
+        int used = fbuf_bytes (fb);
+        output_cb (c->p, c->name);
+        if (fbuf_bytes (fb) == used)
+            break;
+    }
+}
+
 static void local_output (struct subprocess_channel *c,
                           flux_watcher_t *w,
                           int revents,
@@ -183,6 +207,15 @@ static void local_output (struct subprocess_channel *c,
 
         output_cb (c->p, c->name);
 
+        /* Line buffered callers read one line per callback.  Deliver
+         * all buffered lines (up to local_output_batch) now instead of
+         * one per reactor loop iteration, as long as the caller keeps
+         * reading, has not stopped the stream, and still holds a
+         * reference on the subprocess.
+         */
+        if (c->line_buffered && !eof_set)
+            local_output_drain (c, w, output_cb);
+
         if (eof_set) {
             flux_watcher_stop (w);
 
@@ -478,11 +511,31 @@ static void sigchld_cb (pid_t pid, int status, void *arg)
         subprocess_check_completed (p);
 }
 
+/*  posix_spawn(3) avoids copying the parent's page tables, which is
+ *  expensive for a large, multithreaded broker, so prefer it to fork(2)
+ *  whenever the command does not need code to run in the child.
+ *  A working directory can be set with posix_spawn where supported,
+ *  but only if it is accessible, since the fork path falls back to /tmp
+ *  with a warning instead of failing.
+ */
+static bool spawn_cwd_ok (flux_subprocess_t *p)
+{
+    const char *cwd = flux_cmd_getcwd (p->cmd);
+
+    if (!cwd)
+        return true;
+#if HAVE_POSIX_SPAWN_FILE_ACTIONS_ADDCHDIR_NP
+    return access (cwd, X_OK) == 0;
+#else
+    return false;
+#endif
+}
+
 static int create_process (flux_subprocess_t *p)
 {
     if (!(p->flags & FLUX_SUBPROCESS_FLAGS_FORK_EXEC)
         && !p->hooks.pre_exec
-        && !flux_cmd_getcwd (p->cmd))
+        && spawn_cwd_ok (p))
         return create_process_spawn (p);
     return create_process_fork (p);
 }
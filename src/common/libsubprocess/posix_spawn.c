@@ -144,6 +144,18 @@ int create_process_spawn (flux_subprocess_t *p)
      */
     spawn_setup_fds (p, &file_actions);
 
+#if HAVE_POSIX_SPAWN_FILE_ACTIONS_ADDCHDIR_NP
+    /*  Change working directory, if set (see create_process() in local.c)
+     */
+    const char *cwd;
+    if ((cwd = flux_cmd_getcwd (p->cmd))
+        && (retval = posix_spawn_file_actions_addchdir_np (&file_actions,
+                                                           cwd)) != 0) {
+        errno = retval;
+        goto out;
+    }
+#endif
+
     /*  Attempt to spawn a new child process */
     retval = posix_spawnp (&p->pid, argv[0], &file_actions, &attr, argv, env);
     if (retval != 0) {
@@ -1418,6 +1418,96 @@ void test_long_line (flux_reactor_t *r)
     flux_cmd_destroy (cmd);
 }
 
+/* Many lines written at once are delivered by draining the buffer
+ * after the first line, rather than one per reactor loop iteration.
+ * The child writes 1000 numbered lines, and each must arrive in order.
+ */
+int drain_lines;
+int drain_order_errors;
+int drain_stop_at;
+int drain_while_stopped;
+bool drain_stopped;
+
+void drain_timer_cb (flux_reactor_t *r, flux_watcher_t *w,
+                     int revents, void *arg)
+{
+    flux_subprocess_t *p = arg;
+    drain_stopped = false;
+    flux_subprocess_stream_start (p, "stdout");
+    diag ("flux_subprocess_stream_start on stdout");
+    timer_cb_count++;
+}
+
+void drain_output_cb (flux_subprocess_t *p, const char *stream)
+{
+    const char *buf = NULL;
+    int len;
+
+    if (drain_stopped)
+        drain_while_stopped++;
+    len = flux_subprocess_read_line (p, stream, &buf);
+    if (len <= 0) {
+        ok (flux_subprocess_read_stream_closed (p, stream),
+            "flux_subprocess_read_stream_closed saw EOF on %s", stream);
+        return;
+    }
+    if (strtol (buf, NULL, 10) != drain_lines + 1)
+        drain_order_errors++;
+    drain_lines++;
+    if (drain_lines == drain_stop_at) {
+        flux_watcher_t *tw = flux_subprocess_aux_get (p, "tw");
+        flux_subprocess_stream_stop (p, "stdout");
+        diag ("flux_subprocess_stream_stop on stdout");
+        drain_stopped = true;
+        flux_watcher_start (tw);
+    }
+}
+
+void test_line_drain (flux_reactor_t *r, int stop_at)
+{
+    char *av[] = { "/bin/sh", "-c", "seq 1000", NULL };
+    flux_cmd_t *cmd;
+    flux_subprocess_t *p = NULL;
+    flux_watcher_t *tw = NULL;
+
+    ok ((cmd = flux_cmd_create (3, av, environ)) != NULL, "flux_cmd_create");
+
+    flux_subprocess_ops_t ops = {
+        .on_completion = completion_cb,
+        .on_stdout = drain_output_cb
+    };
+    completion_cb_count = 0;
+    timer_cb_count = 0;
+    drain_lines = 0;
+    drain_order_errors = 0;
+    drain_while_stopped = 0;
+    drain_stopped = false;
+    drain_stop_at = stop_at;
+    p = flux_local_exec (r, 0, cmd, &ops);
+    ok (p != NULL, "flux_local_exec");
+
+    ok ((tw = flux_timer_watcher_create (r, 0.1, 0.0,
+                                         drain_timer_cb, p)) != NULL,
+        "flux_timer_watcher_create success");
+    ok (!flux_subprocess_aux_set (p, "tw", tw, NULL),
+        "flux_subprocess_aux_set timer success");
+
+    int rc = flux_reactor_run (r, 0);
+    ok (rc == 0, "flux_reactor_run returned zero status");
+    ok (completion_cb_count == 1, "completion callback called 1 time");
+    ok (drain_lines == 1000,
+        "stdout output callback read 1000 lines: %d", drain_lines);
+    ok (drain_order_errors == 0, "lines were delivered in order");
+    if (stop_at > 0) {
+        ok (drain_while_stopped == 0,
+            "stdout output callback not called after stream stopped");
+        ok (timer_cb_count == 1, "timer callback called 1 time");
+    }
+    flux_subprocess_destroy (p);
+    flux_cmd_destroy (cmd);
+    flux_watcher_destroy (tw);
+}
+
 void credit_output_cb (flux_subprocess_t *p, const char *stream)
 {
     const char *buf = NULL;
@@ -1650,6 +1740,10 @@ int main (int argc, char *argv[])
     test_stream_start_stop_mid_stop (r);
     diag ("long_line");
     test_long_line (r);
+    diag ("line_drain");
+    test_line_drain (r, 0);
+    diag ("line_drain_stop");
+    test_line_drain (r, 10);
     diag ("on_credit");
     test_on_credit (r);
     diag ("on_credit_borrow_credits");
@@ -18,6 +18,7 @@
 #include <signal.h>
 #include <unistd.h>
 #include <sys/mman.h>
+#include <limits.h>
 
 #include "src/common/libtap/tap.h"
 #include "src/common/libsubprocess/subprocess.h"
@@ -433,6 +434,47 @@ void test_env_passed (flux_reactor_t *r)
     flux_cmd_destroy (cmd);
 }
 
+char cwd_output[PATH_MAX + 1];
+
+void cwd_output_cb (flux_subprocess_t *p, const char *stream)
+{
+    const char *buf = NULL;
+    int len;
+
+    if ((len = flux_subprocess_read_trimmed_line (p, stream, &buf)) > 0
+        && streq (stream, "stdout"))
+        snprintf (cwd_output, sizeof (cwd_output), "%s", buf);
+}
+
+void test_cwd (flux_reactor_t *r, const char *cwd, const char *expected)
+{
+    char *av[] = { "/bin/pwd", NULL };
+    flux_cmd_t *cmd;
+    flux_subprocess_t *p = NULL;
+
+    ok ((cmd = flux_cmd_create (1, av, environ)) != NULL, "flux_cmd_create");
+    ok (flux_cmd_setcwd (cmd, cwd) == 0, "flux_cmd_setcwd %s", cwd);
+
+    flux_subprocess_ops_t ops = {
+        .on_completion = completion_cb,
+        .on_stdout = cwd_output_cb,
+        .on_stderr = cwd_output_cb,
+    };
+    completion_cb_count = 0;
+    cwd_output[0] = '\0';
+    p = flux_local_exec (r, 0, cmd, &ops);
+    ok (p != NULL, "flux_local_exec");
+
+    int rc = flux_reactor_run (r, 0);
+    ok (rc == 0, "flux_reactor_run returned zero status");
+    ok (completion_cb_count == 1, "completion callback called 1 time");
+    ok (streq (cwd_output, expected),
+        "subprocess ran in %s", expected);
+    diag ("pwd: %s", cwd_output);
+    flux_subprocess_destroy (p);
+    flux_cmd_destroy (cmd);
+}
+
 void completion_sigterm_cb (flux_subprocess_t *p)
 {
     ok (flux_subprocess_state (p) == FLUX_SUBPROCESS_EXITED,
@@ -1250,6 +1292,10 @@ int main (int argc, char *argv[])
     test_basic_fail (r);
     diag ("env_passed");
     test_env_passed (r);
+    diag ("cwd");
+    test_cwd (r, "/", "/");
+    diag ("cwd_missing");
+    test_cwd (r, "/nonexistent-dir", "/tmp");
     diag ("flag_no_setpgrp");
     test_flag_no_setpgrp (r);
     diag ("flag_fork_exec");
@@ -12,6 +12,12 @@
 #include "config.h"
 #endif
 
+#include <stdlib.h>
+#include <errno.h>
+#include <limits.h>
+#include <string.h>
+#include <ctype.h>
+
 #include "kary.h"
 
 uint32_t kary_parentof (int k, uint32_t i)
@@ -92,6 +98,76 @@ uint32_t kary_child_route (int k, uint32_t size, uint32_t src, uint32_t dst)
     return KARY_NONE;
 }
 
+int kary_parse_topo (const char *topo)
+{
+    char *endptr;
+    long k;
+
+    if (!topo
+        || strncmp (topo, "kary:", 5) != 0
+        || !isdigit ((unsigned char)topo[5]))
+        goto inval;
+    errno = 0;
+    k = strtol (topo + 5, &endptr, 10);
+    if (errno != 0 || *endptr != '\0' || k <= 0 || k > INT_MAX)
+        goto inval;
+    return k;
+inval:
+    errno = EINVAL;
+    return -1;
+}
+
+struct rank_order {
+    uint32_t rank;
+    uint64_t key;
+};
+
+static int rank_order_cmp (const void *a, const void *b)
+{
+    const struct rank_order *r1 = a;
+    const struct rank_order *r2 = b;
+    return (r1->key > r2->key) - (r1->key < r2->key);
+}
+
+int kary_interleave_subtrees (int k, uint32_t size, uint32_t *ranks, int n)
+{
+    struct rank_order *ro;
+    uint64_t *seq;
+    int i;
+
+    if (k <= 0 || n < 0 || (n > 0 && !ranks)) {
+        errno = EINVAL;
+        return -1;
+    }
+    if (n <= 1)
+        return 0;
+    if (!(ro = calloc (n, sizeof (*ro))))
+        return -1;
+    if (!(seq = calloc (k + 1, sizeof (*seq)))) {
+        free (ro);
+        return -1;
+    }
+    /* Subtree 0 holds rank 0 and any rank outside the tree, subtree b
+     * holds rank b and its descendants.  The key sorts the ith rank of
+     * each subtree ahead of the (i+1)th rank of any subtree.
+     */
+    for (i = 0; i < n; i++) {
+        uint32_t b = 0;
+        if (ranks[i] > 0 && ranks[i] < size)
+            b = kary_child_route (k, size, 0, ranks[i]);
+        if (b == KARY_NONE || b > (uint32_t)k)
+            b = 0;
+        ro[i].rank = ranks[i];
+        ro[i].key = seq[b]++ * (k + 1) + b;
+    }
+    qsort (ro, n, sizeof (*ro), rank_order_cmp);
+    for (i = 0; i < n; i++)
+        ranks[i] = ro[i].rank;
+    free (ro);
+    free (seq);
+    return 0;
+}
+
 
 /*
  * vi:tabstop=4 shiftwidth=4 expandtab
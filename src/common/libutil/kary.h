@@ -47,6 +47,18 @@ uint32_t kary_parent_route (int k, uint32_t size, uint32_t src, uint32_t dst);
  */
 uint32_t kary_child_route (int k, uint32_t size, uint32_t src, uint32_t dst);
 
+/* Parse a topology string of the form "kary:K" (c.f. tbon.topo).
+ * Return K, or -1 with errno set to EINVAL if topo is not of that form.
+ */
+int kary_parse_topo (const char *topo);
+
+/* Reorder the n ranks in 'ranks' round-robin across the subtrees rooted at
+ * the children of rank 0: the ith rank of each subtree sorts ahead of the
+ * (i+1)th rank of any subtree.  Rank 0 and ranks outside the tree are
+ * grouped together ahead of subtree 1.  Relative order within a subtree
+ * is preserved.  Return 0 on success, -1 on failure with errno set.
+ */
+int kary_interleave_subtrees (int k, uint32_t size, uint32_t *ranks, int n);
 
 #endif /* !_UTIL_KARY_H */
 
@@ -11,9 +11,75 @@
 #if HAVE_CONFIG_H
 #include "config.h"
 #endif
+#include <errno.h>
+#include <string.h>
+#include <stdbool.h>
+
 #include "src/common/libtap/tap.h"
 #include "src/common/libutil/kary.h"
 
+static bool ranks_equal (const uint32_t *a, const uint32_t *b, int n)
+{
+    return memcmp (a, b, n * sizeof (a[0])) == 0;
+}
+
+static void test_parse_topo (void)
+{
+    ok (kary_parse_topo ("kary:8") == 8,
+        "kary_parse_topo kary:8 returns 8");
+    ok (kary_parse_topo ("kary:1") == 1,
+        "kary_parse_topo kary:1 returns 1");
+
+    const char *bad[] = {
+        "kary:8x", "kary:", "kary:0", "kary:-2", "kary: 2", "kary:99999999999",
+        "binomial", "custom", "Kary:2", "", NULL,
+    };
+    for (int i = 0; i < sizeof (bad) / sizeof (bad[0]); i++) {
+        errno = 0;
+        ok (kary_parse_topo (bad[i]) < 0 && errno == EINVAL,
+            "kary_parse_topo %s fails with EINVAL",
+            bad[i] ? bad[i] : "NULL");
+    }
+}
+
+static void test_interleave (void)
+{
+    /* k=2, size=7: subtree 1 = {1,3,4}, subtree 2 = {2,5,6} */
+    uint32_t all[] = { 0, 1, 2, 3, 4, 5, 6 };
+    uint32_t all_x[] = { 0, 1, 2, 3, 5, 4, 6 };
+    uint32_t sub[] = { 3, 4, 5, 6 };
+    uint32_t sub_x[] = { 3, 5, 4, 6 };
+    uint32_t out[] = { 0, 1, 2, 3, 4, 5, 6, 9 };
+    uint32_t out_x[] = { 0, 1, 2, 9, 3, 5, 4, 6 };
+    uint32_t one[] = { 5 };
+
+    ok (kary_interleave_subtrees (2, 7, all, 7) == 0
+        && ranks_equal (all, all_x, 7),
+        "k=2,size=7: ranks 0-6 alternate between subtrees");
+    ok (kary_interleave_subtrees (2, 7, sub, 4) == 0
+        && ranks_equal (sub, sub_x, 4),
+        "k=2,size=7: ranks 3-6 alternate between subtrees");
+    ok (kary_interleave_subtrees (2, 7, out, 8) == 0
+        && ranks_equal (out, out_x, 8),
+        "k=2,size=7: rank outside tree is grouped with rank 0");
+    ok (kary_interleave_subtrees (2, 7, one, 1) == 0 && one[0] == 5,
+        "k=2,size=7: single rank is unchanged");
+
+    /* k=1: every rank is in subtree 1, so order is preserved */
+    uint32_t chain[] = { 0, 1, 2, 3 };
+    uint32_t chain_x[] = { 0, 1, 2, 3 };
+    ok (kary_interleave_subtrees (1, 4, chain, 4) == 0
+        && ranks_equal (chain, chain_x, 4),
+        "k=1,size=4: order is preserved");
+
+    errno = 0;
+    ok (kary_interleave_subtrees (0, 7, all, 7) < 0 && errno == EINVAL,
+        "kary_interleave_subtrees k=0 fails with EINVAL");
+    errno = 0;
+    ok (kary_interleave_subtrees (2, 7, NULL, 2) < 0 && errno == EINVAL,
+        "kary_interleave_subtrees ranks=NULL fails with EINVAL");
+}
+
 int main(int argc, char** argv)
 {
     plan (NO_PLAN);
@@ -178,5 +244,8 @@ int main(int argc, char** argv)
     ok (kary_childof (1, 6, 5, 0) == KARY_NONE,
         "k=1,size=6: rank 2 has no child 0");
 
+    test_parse_topo ();
+    test_interleave ();
+
     done_testing();
 }
@@ -596,6 +596,11 @@ static int exec_init (struct jobinfo *job)
         flux_log_error (job->h, "exec_init: bulk_exec_create");
         goto err;
     }
+    if (bulk_exec_set_max_per_loop (exec,
+                                    config_get_max_start_per_loop ()) < 0) {
+        flux_log_error (job->h, "exec_init: bulk_exec_set_max_per_loop");
+        goto err;
+    }
     if (!(ctx = exec_ctx_create (job, ranks, &error))) {
         flux_log (job->h, LOG_ERR, "exec_ctx_create: %s", error.text);
         goto err;
@@ -39,6 +39,7 @@ struct exec_config {
     int sdexec_stop_timer_sec;
     int sdexec_stop_timer_signal;
     double default_barrier_timeout;
+    int max_start_per_loop;
 };
 
 /* Global configs initialized in config_init() */
@@ -128,11 +129,16 @@ double config_get_default_barrier_timeout (void)
     return exec_conf.default_barrier_timeout;
 }
 
+int config_get_max_start_per_loop (void)
+{
+    return exec_conf.max_start_per_loop;
+}
+
 int config_get_stats (json_t **config_stats)
 {
     json_t *o = NULL;
 
-    if (!(o = json_pack ("{s:s? s:s? s:s? s:s? s:i s:f s:i s:i}",
+    if (!(o = json_pack ("{s:s? s:s? s:s? s:s? s:i s:f s:i s:i s:i}",
                          "default_cwd", default_cwd,
                          "default_job_shell", exec_conf.default_job_shell,
                          "flux_imp_path", exec_conf.flux_imp_path,
@@ -144,7 +150,9 @@ int config_get_stats (json_t **config_stats)
                          "sdexec_stop_timer_sec",
                          exec_conf.sdexec_stop_timer_sec,
                          "sdexec_stop_timer_signal",
-                         exec_conf.sdexec_stop_timer_signal))) {
+                         exec_conf.sdexec_stop_timer_signal,
+                         "max_start_per_loop",
+                         exec_conf.max_start_per_loop))) {
         errno = ENOMEM;
         return -1;
     }
@@ -176,6 +184,7 @@ static void exec_config_init (struct exec_config *ec)
     ec->sdexec_stop_timer_sec = 30;
     ec->sdexec_stop_timer_signal = 10; // SIGUSR1
     ec->default_barrier_timeout = 1800.;
+    ec->max_start_per_loop = 1;
 }
 
 /*  Initialize configurations for use by job-exec bulk-exec
@@ -307,6 +316,23 @@ int config_setup (flux_t *h,
         return -1;
     }
 
+    /*  Check configuration for exec.max-start-per-loop */
+    if (flux_conf_unpack (conf,
+                          &err,
+                          "{s?{s?i}}",
+                          "exec",
+                            "max-start-per-loop",
+                              &tmpconf.max_start_per_loop) < 0) {
+        errprintf (errp,
+                   "error reading config value exec.max-start-per-loop: %s",
+                   err.text);
+        return -1;
+    }
+    if (tmpconf.max_start_per_loop < 1) {
+        errprintf (errp, "exec.max-start-per-loop must be >= 1");
+        errno = EINVAL;
+        return -1;
+    }
 
     if (argv && argc) {
         /* Finally, override values on cmdline */
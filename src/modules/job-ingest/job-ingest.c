@@ -26,6 +26,7 @@
 #include "src/common/libutil/jpath.h"
 #include "src/common/libutil/errprintf.h"
 #include "src/common/libutil/parse_size.h"
+#include "src/common/libutil/monotime.h"
 #include "src/common/libjob/job_hash.h"
 #include "src/common/libfluxutil/policy.h"
 #include "ccan/str/str.h"
@@ -44,9 +45,17 @@
  * 5) make "job-manager.submit" request announcing new jobid
  *
  * For performance, the above actions are batched, so that if job requests
- * arrive within the 'batch_timeout' window, they are combined into one
+ * arrive within the batch window, they are combined into one
  * KVS transaction and one job-manager request.
  *
+ * The batch window adapts to load.  When no batch is being committed,
+ * a new batch is flushed on the next reactor loop iteration, so a lone
+ * job is not delayed.  While a batch is being committed, the next batch
+ * accumulates until that commit completes, up to the smoothed commit
+ * latency or 'batch_timeout', whichever is less.  Batches are also
+ * flushed once they hold as many jobs as are expected to arrive during
+ * two commits, given the smoothed arrival rate.
+ *
  * The jobid is returned to the user in response to the job-ingest.submit RPC.
  * Responses are sent after the job has been successfully ingested.
  *
@@ -56,9 +65,17 @@
  *   job.0000.0004.b200.0000
  *
  * The job-ingest module can be loaded on rank 0, or on many ranks across
- * the instance, rank < max FLUID id - 1.  Each rank is relatively
- * independent and KVS commit scalability will ultimately limit the max
- * ingest rate for an instance.
+ * the instance, rank < max FLUID id - 1.  Each rank validates jobs and
+ * assigns jobids independently.  Unless the module is loaded with the
+ * 'no-relay' option, ranks other than 0 do not commit to the KVS or
+ * announce jobs themselves.  Instead each batch is forwarded upstream in
+ * a single "job-ingest.relay" request.  An upstream job-ingest adds
+ * relayed jobs to its own batch, so batches from a subtree are aggregated
+ * on the way to rank 0, which makes one KVS commit and one job-manager
+ * request per batch.  The relay response has the same form as the
+ * job-manager.submit response and is passed back down to the requestors.
+ * If job-ingest is not loaded upstream, the relay fails with ENOSYS and
+ * the rank falls back to committing and announcing its own batches.
  *
  * Security: any user with FLUX_ROLE_USER may submit jobs.  The jobspec
  * must be signed, but this module (running as the instance owner) doesn't
@@ -76,6 +93,33 @@
  */
 static const double batch_timeout = 0.01;
 
+/* Bounds on the adaptive batch count limit.
+ */
+static const int batch_count_min = 64;
+static const int batch_count_max = 8192;
+
+/* Weight given to each new sample in smoothed commit latency
+ * and job inter-arrival time.
+ */
+static const double ewma_alpha = 0.125;
+
+/* Batch size and commit latency (milliseconds) histograms have
+ * power of two buckets: bucket i counts values <= 2^i, and the last
+ * bucket counts everything larger.
+ */
+#define HIST_BUCKETS 15
+
+struct batch_stats {
+    int inflight;               // batches currently being committed
+    double commit_latency;      // smoothed KVS commit latency (s)
+    double interarrival;        // smoothed time between jobs (s)
+    struct timespec t_last;     // time of last job arrival
+    int size_hist[HIST_BUCKETS];
+    int latency_hist[HIST_BUCKETS];
+    int relay_requests;         // relay requests received from downstream
+    int relay_jobs;             // jobs received in relay requests
+};
+
 /* There can be 2^14 FLUID generators per RFC 19.
  * Reserve the top 16 for future use.
  * This value may be set on the command line for testing.
@@ -88,6 +132,11 @@ static int max_fluid_generator_id = 16384 - 16 - 1;
  */
 static bool allow_root_jobs = false;
 
+/* By default, job-ingest on ranks other than 0 relays batches upstream.
+ * The 'no-relay' option restores rank-local KVS commits for testing.
+ */
+static bool relay_disabled = false;
+
 struct job_ingest_ctx {
     flux_t *h;
     struct pipeline *pipeline;
@@ -105,15 +154,29 @@ struct job_ingest_ctx {
 
     int batch_count;            // if nonzero, batch by count not timer
     const char *buffer_size;
+    struct batch_stats stats;
 
+    bool relay;                 // forward batches upstream instead of commit
     bool shutdown;
 };
 
 struct batch {
     struct job_ingest_ctx *ctx;
+    struct timespec t_flush;
     flux_kvs_txn_t *txn;
     zlist_t *jobs;
+    zlist_t *relays;
     json_t *joblist;
+    bool relay;                 // joblist holds entries to relay upstream
+};
+
+/* A relay request from downstream, whose jobs occupy 'count' entries
+ * of the batch joblist beginning at 'start'.
+ */
+struct relay {
+    const flux_msg_t *msg;
+    size_t start;
+    size_t count;
 };
 
 struct batch_response {
@@ -124,7 +187,20 @@ struct batch_response {
     zhashx_t *errors;
 };
 
-static int make_key (char *buf, int bufsz, struct job *job, const char *name);
+static int make_key (char *buf,
+                     int bufsz,
+                     flux_jobid_t id,
+                     const char *name);
+
+static void relay_destroy (struct relay *relay)
+{
+    if (relay) {
+        int saved_errno = errno;
+        flux_msg_decref (relay->msg);
+        free (relay);
+        errno = saved_errno;
+    }
+}
 
 static void batch_destroy (struct batch *batch)
 {
@@ -135,17 +211,23 @@ static void batch_destroy (struct batch *batch)
             while ((job = zlist_pop (batch->jobs)))
                 job_destroy (job);
             zlist_destroy (&batch->jobs);
-            json_decref (batch->joblist);
-            flux_kvs_txn_destroy (batch->txn);
         }
+        if (batch->relays) {
+            struct relay *relay;
+            while ((relay = zlist_pop (batch->relays)))
+                relay_destroy (relay);
+            zlist_destroy (&batch->relays);
+        }
+        json_decref (batch->joblist);
+        flux_kvs_txn_destroy (batch->txn);
         free (batch);
         errno = saved_errno;
     }
 }
 
 /* Create a 'struct batch', a container for a group of job submit
- * requests.  Prepare a KVS transaction and a json array of jobid's
- * to be used for job-manager.submit request.
+ * and relay requests.  Prepare a KVS transaction and a json array of job
+ * entries to be used for the job-manager.submit or job-ingest.relay request.
  */
 static struct batch *batch_create (struct job_ingest_ctx *ctx)
 {
@@ -153,13 +235,15 @@ static struct batch *batch_create (struct job_ingest_ctx *ctx)
 
     if (!(batch = calloc (1, sizeof (*batch))))
         return NULL;
-    if (!(batch->jobs = zlist_new ()))
+    if (!(batch->jobs = zlist_new ())
+        || !(batch->relays = zlist_new ()))
         goto nomem;
     if (!(batch->txn = flux_kvs_txn_create ()))
         goto error;
     if (!(batch->joblist = json_array ()))
         goto nomem;
     batch->ctx = ctx;
+    batch->relay = ctx->relay;
     return batch;
 nomem:
     errno = ENOMEM;
@@ -254,11 +338,59 @@ static void batch_respond_error (struct batch *batch,
 {
     flux_t *h = batch->ctx->h;
     struct job *job = zlist_first (batch->jobs);
+    struct relay *relay;
+
     while (job) {
         if (flux_respond_error (h, job->msg, errnum, errstr) < 0)
             flux_log_error (h, "%s: flux_respond_error", __FUNCTION__);
         job = zlist_next (batch->jobs);
     }
+    relay = zlist_first (batch->relays);
+    while (relay) {
+        if (flux_respond_error (h, relay->msg, errnum, errstr) < 0)
+            flux_log_error (h, "%s: flux_respond_error", __FUNCTION__);
+        relay = zlist_next (batch->relays);
+    }
+}
+
+/* Respond to a relay request with the errors, if any, for its jobs,
+ * in the same form as the job-manager.submit response.
+ */
+static void relay_respond (struct batch *batch,
+                           struct relay *relay,
+                           struct batch_response *br)
+{
+    flux_t *h = batch->ctx->h;
+    json_t *errors = NULL;
+    int rc;
+
+    for (size_t i = relay->start; i < relay->start + relay->count; i++) {
+        json_t *entry = json_array_get (batch->joblist, i);
+        flux_jobid_t id;
+        const char *errmsg;
+        json_t *o;
+
+        if (json_unpack (entry, "{s:I}", "id", &id) < 0
+            || !(errmsg = zhashx_lookup (br->errors, &id)))
+            continue;
+        if (!errors && !(errors = json_array ()))
+            goto nomem;
+        if (!(o = json_pack ("[Is]", id, errmsg))
+            || json_array_append_new (errors, o) < 0)
+            goto nomem;
+    }
+    if (errors)
+        rc = flux_respond_pack (h, relay->msg, "{s:O}", "errors", errors);
+    else
+        rc = flux_respond (h, relay->msg, NULL);
+    if (rc < 0)
+        flux_log_error (h, "%s: flux_respond", __FUNCTION__);
+    json_decref (errors);
+    return;
+nomem:
+    if (flux_respond_error (h, relay->msg, ENOMEM, NULL) < 0)
+        flux_log_error (h, "%s: flux_respond_error", __FUNCTION__);
+    json_decref (errors);
 }
 
 /* Respond to all requestors (for each job) with their id or an error if
@@ -269,6 +401,7 @@ static void batch_respond (struct batch *batch, struct batch_response *br)
     flux_t *h = batch->ctx->h;
     const char *errmsg;
     struct job *job = zlist_first (batch->jobs);
+    struct relay *relay;
 
     if (br->batch_failed) {
         batch_respond_error (batch, br->errnum, br->errmsg);
@@ -284,6 +417,11 @@ static void batch_respond (struct batch *batch, struct batch_response *br)
             flux_log_error (h, "%s: flux_respond_pack", __FUNCTION__);
         job = zlist_next (batch->jobs);
     }
+    relay = zlist_first (batch->relays);
+    while (relay) {
+        relay_respond (batch, relay, br);
+        relay = zlist_next (batch->relays);
+    }
 }
 
 static void batch_cleanup_continuation (flux_future_t *f, void *arg)
@@ -296,30 +434,38 @@ static void batch_cleanup_continuation (flux_future_t *f, void *arg)
 }
 
 /* Remove KVS job entries previously committed for all failed jobs in batch.
+ * A relaying batch made no KVS commit, so there is nothing to remove.
  */
 static int batch_cleanup (struct batch *batch, struct batch_response *br)
 {
     flux_t *h = batch->ctx->h;
     flux_kvs_txn_t *txn;
-    struct job *job;
     flux_future_t *f = NULL;
+    size_t index;
+    json_t *entry;
     char key[64];
     int count = 0;
 
+    if (batch->relay)
+        return 0;
     if (!(txn = flux_kvs_txn_create ()))
         return -1;
-    job = zlist_first (batch->jobs);
-    while (job) {
+    json_array_foreach (batch->joblist, index, entry) {
+        flux_jobid_t id;
+
+        if (json_unpack (entry, "{s:I}", "id", &id) < 0) {
+            errno = EPROTO;
+            goto error;
+        }
         if (br == NULL
             || br->batch_failed
-            || zhashx_lookup (br->errors, &job->id)) {
-            if (make_key (key, sizeof (key), job, NULL) < 0)
+            || zhashx_lookup (br->errors, &id)) {
+            if (make_key (key, sizeof (key), id, NULL) < 0)
                 goto error;
             if (flux_kvs_txn_unlink (txn, 0, key) < 0)
                 goto error;
             count++;
         }
-        job = zlist_next (batch->jobs);
     }
     if (count > 0) {
         if (!(f = flux_kvs_commit (h, NULL, 0, txn)))
@@ -384,13 +530,118 @@ error:
     flux_future_destroy (f);
 }
 
+static void hist_add (int *hist, double value)
+{
+    int i = 0;
+    while (i < HIST_BUCKETS - 1 && value > (1 << i))
+        i++;
+    hist[i]++;
+}
+
+static json_t *hist_encode (int *hist)
+{
+    json_t *o;
+
+    if (!(o = json_object ()))
+        return NULL;
+    for (int i = 0; i < HIST_BUCKETS; i++) {
+        char key[16];
+        json_t *count;
+
+        if (i < HIST_BUCKETS - 1)
+            snprintf (key, sizeof (key), "%d", 1 << i);
+        else
+            snprintf (key, sizeof (key), "inf");
+        if (!(count = json_integer (hist[i]))
+            || json_object_set_new (o, key, count) < 0) {
+            json_decref (count);
+            json_decref (o);
+            return NULL;
+        }
+    }
+    return o;
+}
+
+static double ewma (double avg, double sample)
+{
+    if (avg == 0.)
+        return sample;
+    return avg + ewma_alpha * (sample - avg);
+}
+
+/* Return the time (s) a new batch may accumulate jobs before it is
+ * flushed.  If nothing is being committed, flush on the next reactor
+ * loop iteration.  Otherwise wait for the commit to complete.
+ */
+static double batch_window (struct batch_stats *stats)
+{
+    if (stats->inflight == 0)
+        return 0.;
+    if (stats->commit_latency > 0. && stats->commit_latency < batch_timeout)
+        return stats->commit_latency;
+    return batch_timeout;
+}
+
+/* Return the number of jobs at which a batch is flushed without waiting
+ * for the window to close: twice the jobs expected to arrive during one
+ * commit, within bounds.
+ */
+static int batch_limit (struct batch_stats *stats)
+{
+    double n;
+
+    if (stats->interarrival <= 0.)
+        return batch_count_max;
+    n = 2. * stats->commit_latency / stats->interarrival;
+    if (n < batch_count_min)
+        return batch_count_min;
+    if (n > batch_count_max)
+        return batch_count_max;
+    return (int)n;
+}
+
+static void batch_stats_arrival (struct batch_stats *stats)
+{
+    if (monotime_isset (stats->t_last))
+        stats->interarrival = ewma (stats->interarrival,
+                                    monotime_since (stats->t_last) * 1E-3);
+    monotime (&stats->t_last);
+}
+
+static void batch_stats_committed (struct batch_stats *stats,
+                                   struct batch *batch)
+{
+    double latency = monotime_since (batch->t_flush);
+
+    stats->inflight--;
+    stats->commit_latency = ewma (stats->commit_latency, latency * 1E-3);
+    hist_add (stats->latency_hist, latency);
+}
+
+static void batch_flush (struct job_ingest_ctx *ctx);
+static int batch_commit (struct batch *batch);
+static int batch_add_entry (struct batch *batch, json_t *entry);
+
+/* Flush the batch that accumulated while the previous one was in flight.
+ */
+static void batch_flush_pending (struct job_ingest_ctx *ctx)
+{
+    if (ctx->batch && !ctx->batch_count) {
+        flux_watcher_stop (ctx->timer);
+        batch_flush (ctx);
+    }
+}
+
 /* Get result of KVS commit.
  * If successful, announce job(s) to job-manager.
+ * Then flush the next batch if one has accumulated during the commit.
  */
 static void batch_flush_continuation (flux_future_t *f, void *arg)
 {
     struct batch *batch = arg;
+    struct job_ingest_ctx *ctx = batch->ctx;
 
+    batch_stats_committed (&ctx->stats, batch);
     if (flux_future_get (f, NULL) < 0) {
         batch_respond_error (batch, errno, "KVS commit failed");
         batch_destroy (batch);
@@ -399,38 +650,154 @@ static void batch_flush_continuation (flux_future_t *f, void *arg)
         batch_announce (batch);
     }
     flux_future_destroy (f);
+
+    batch_flush_pending (ctx);
 }
 
-/*
- * Replace ctx->batch with a NULL, and pass 'batch' off to a chain of
- * continuations that commit its data to the KVS, respond to requestors,
- * and announce the new jobids.
+/* job-ingest is not loaded upstream, so stop relaying and commit 'batch'
+ * on this rank instead, converting its entries to a KVS transaction and
+ * job-manager.submit entries.  Entry order is preserved, so downstream
+ * relay requests keep their positions in the joblist.
  */
-static void batch_flush (struct job_ingest_ctx *ctx)
+static void batch_relay_fallback (struct batch *batch)
 {
-    struct batch *batch;
+    struct job_ingest_ctx *ctx = batch->ctx;
+    json_t *joblist = batch->joblist;
+    size_t index;
+    json_t *entry;
+
+    if (ctx->relay) {
+        flux_log (ctx->h,
+                  LOG_INFO,
+                  "job-ingest is not loaded upstream, disabling relay");
+        ctx->relay = false;
+    }
+    if (!(batch->joblist = json_array ())) {
+        batch->joblist = joblist;
+        batch_respond_error (batch, ENOMEM, "error disabling relay");
+        goto error;
+    }
+    batch->relay = false;
+    json_array_foreach (joblist, index, entry) {
+        if (batch_add_entry (batch, entry) < 0) {
+            batch_respond_error (batch, errno, "error disabling relay");
+            goto error;
+        }
+    }
+    json_decref (joblist);
+    monotime (&batch->t_flush);
+    if (batch_commit (batch) < 0) {
+        batch_destroy (batch);
+        return;
+    }
+    ctx->stats.inflight++;
+    return;
+error:
+    if (batch->joblist != joblist)
+        json_decref (joblist);
+    batch_destroy (batch);
+}
+
+/* Get result of relaying job(s) upstream and respond to requestors,
+ * then flush the next batch if one has accumulated.
+ */
+static void batch_relay_continuation (flux_future_t *f, void *arg)
+{
+    struct batch *batch = arg;
+    struct job_ingest_ctx *ctx = batch->ctx;
+
+    batch_stats_committed (&ctx->stats, batch);
+    if (flux_future_get (f, NULL) < 0 && errno == ENOSYS) {
+        flux_future_destroy (f);
+        batch_relay_fallback (batch);
+    }
+    else
+        batch_announce_continuation (f, batch);
+
+    batch_flush_pending (ctx);
+}
+
+/* Forward 'batch' upstream in one job-ingest.relay request.
+ */
+static int batch_relay (struct batch *batch)
+{
+    flux_t *h = batch->ctx->h;
     flux_future_t *f;
 
-    batch = ctx->batch;
-    ctx->batch = NULL;
+    if (!(f = flux_rpc_pack (h,
+                             "job-ingest.relay",
+                             FLUX_NODEID_UPSTREAM,
+                             0,
+                             "{s:O}",
+                             "jobs", batch->joblist))) {
+        batch_respond_error (batch,
+                             errno,
+                             "error sending job-ingest.relay RPC");
+        return -1;
+    }
+    if (flux_future_then (f, -1., batch_relay_continuation, batch) < 0) {
+        batch_respond_error (batch, errno, "flux_future_then (relay) failed");
+        flux_future_destroy (f);
+        return -1;
+    }
+    return 0;
+}
+
+/* Commit 'batch' to the KVS, then announce it to the job manager.
+ * On failure, respond to requestors with an error.
+ */
+static int batch_commit (struct batch *batch)
+{
+    struct job_ingest_ctx *ctx = batch->ctx;
+    flux_future_t *f;
 
     if (!(f = flux_kvs_commit (ctx->h, NULL, 0, batch->txn))) {
         batch_respond_error (batch, errno, "flux_kvs_commit failed");
-        goto error;
+        return -1;
     }
     if (flux_future_then (f, -1., batch_flush_continuation, batch) < 0) {
         batch_respond_error (batch, errno, "flux_future_then (kvs) failed");
         flux_future_destroy (f);
         if (batch_cleanup (batch, NULL) < 0)
             flux_log_error (ctx->h, "%s: KVS cleanup failure", __FUNCTION__);
+        return -1;
+    }
+    return 0;
+}
+
+/*
+ * Replace ctx->batch with a NULL, and pass 'batch' off to a chain of
+ * continuations that commit its data to the KVS, respond to requestors,
+ * and announce the new jobids.  If relaying, pass it upstream instead.
+ */
+static void batch_flush (struct job_ingest_ctx *ctx)
+{
+    struct batch *batch;
+
+    batch = ctx->batch;
+    ctx->batch = NULL;
+
+    if (json_array_size (batch->joblist) == 0)
         goto error;
+
+    monotime (&batch->t_flush);
+    hist_add (ctx->stats.size_hist, json_array_size (batch->joblist));
+
+    if (batch->relay) {
+        if (batch_relay (batch) < 0)
+            goto error;
+        ctx->stats.inflight++;
+        return;
     }
+    if (batch_commit (batch) < 0)
+        goto error;
+    ctx->stats.inflight++;
     return;
 error:
     batch_destroy (batch);
 }
 
-/* batch timer - expires 'batch_timeout' seconds after batch was created.
+/* batch timer - expires when the batch window closes.
  */
 static void batch_timer_cb (flux_reactor_t *r,
                             flux_watcher_t *w,
@@ -440,11 +807,14 @@ static void batch_timer_cb (flux_reactor_t *r,
     batch_flush ((struct job_ingest_ctx *) arg);
 }
 
-/* Format key within the KVS directory of 'job'.
+/* Format key within the KVS directory of job 'id'.
  */
-static int make_key (char *buf, int bufsz, struct job *job, const char *name)
+static int make_key (char *buf,
+                     int bufsz,
+                     flux_jobid_t id,
+                     const char *name)
 {
-    if (flux_job_kvs_key (buf, bufsz, job->id, name) < 0) {
+    if (flux_job_kvs_key (buf, bufsz, id, name) < 0) {
         errno = EINVAL;
         return -1;
     }
@@ -462,78 +832,170 @@ static double get_timestamp_now (void)
     return now;
 }
 
-/* Add 'job' to 'batch'.
+/* Add job 'entry' to 'batch'.  If relaying, the entry is forwarded upstream
+ * as is.  Otherwise, J and jobspec are added to the KVS transaction and the
+ * remainder of the entry is announced to the job manager.
  * On error, ensure that no remnants of job made into KVS transaction.
  */
-static int batch_add_job (struct batch *batch, struct job *job)
+static int batch_add_entry (struct batch *batch, json_t *entry)
 {
+    flux_jobid_t id;
+    const char *J;
+    json_t *jobspec;
+    json_t *announce;
     char key[64];
     int saved_errno;
-    json_t *jobentry;
 
-    if (zlist_append (batch->jobs, job) < 0) {
-        errno = ENOMEM;
+    if (batch->relay) {
+        if (json_array_append (batch->joblist, entry) < 0) {
+            errno = ENOMEM;
+            return -1;
+        }
+        return 0;
+    }
+    if (json_unpack (entry,
+                     "{s:I s:s s:o}",
+                     "id", &id,
+                     "J", &J,
+                     "jobspec", &jobspec) < 0) {
+        errno = EPROTO;
         return -1;
     }
-    if (make_key (key, sizeof (key), job, "J") < 0)
+    if (make_key (key, sizeof (key), id, "J") < 0)
+        goto error;
+    if (flux_kvs_txn_put (batch->txn, 0, key, J) < 0)
         goto error;
-    if (flux_kvs_txn_put (batch->txn, 0, key, job->J) < 0)
+    if (make_key (key, sizeof (key), id, "jobspec") < 0)
         goto error;
-    if (make_key (key, sizeof (key), job, "jobspec") < 0)
+    if (flux_kvs_txn_pack (batch->txn, 0, key, "O", jobspec) < 0)
         goto error;
+    if (!(announce = json_copy (entry)))
+        goto nomem;
+    (void)json_object_del (announce, "J");
+    if (json_array_append_new (batch->joblist, announce) < 0)
+        goto nomem;
+    return 0;
+nomem:
+    errno = ENOMEM;
+error:
+    saved_errno = errno;
+    if (make_key (key, sizeof (key), id, NULL) == 0)
+        (void)flux_kvs_txn_unlink (batch->txn, 0, key);
+    errno = saved_errno;
+    return -1;
+}
+
+/* Remove entries beyond the first 'size' from 'batch', e.g. after failing
+ * to add all the jobs of a relay request.
+ */
+static void batch_truncate (struct batch *batch, size_t size)
+{
+    size_t index;
+
+    while ((index = json_array_size (batch->joblist)) > size) {
+        json_t *entry = json_array_get (batch->joblist, --index);
+        flux_jobid_t id;
+        char key[64];
+
+        if (!batch->relay
+            && json_unpack (entry, "{s:I}", "id", &id) == 0
+            && make_key (key, sizeof (key), id, NULL) == 0)
+            (void)flux_kvs_txn_unlink (batch->txn, 0, key);
+        (void)json_array_remove (batch->joblist, index);
+    }
+}
+
+/* Add 'job' to 'batch'.
+ */
+static int batch_add_job (struct batch *batch, struct job *job)
+{
+    json_t *jobentry;
+    int saved_errno;
+
+    if (zlist_append (batch->jobs, job) < 0) {
+        errno = ENOMEM;
+        return -1;
+    }
     /* Drop environment from the jobspec to reduce its bulk.
      * If needed, it can be extracted from J.
      * See also flux-framework/flux-core#4520
      */
     jpath_del (job->jobspec, "attributes.system.environment");
-    if (flux_kvs_txn_pack (batch->txn, 0, key, "O", job->jobspec) < 0)
-        goto error;
-    if (!(jobentry = json_pack ("{s:I s:I s:i s:f s:i, s:O}",
+    if (!(jobentry = json_pack ("{s:I s:I s:i s:f s:i s:O s:s}",
                                 "id", job->id,
                                 "userid", (json_int_t) job->cred.userid,
                                 "urgency", job->urgency,
                                 "t_submit", get_timestamp_now (),
                                 "flags", job->flags,
-                                "jobspec", job->jobspec)))
-        goto nomem;
-    if (json_array_append_new (batch->joblist, jobentry) < 0) {
+                                "jobspec", job->jobspec,
+                                "J", job->J))) {
+        errno = ENOMEM;
+        goto error;
+    }
+    if (batch_add_entry (batch, jobentry) < 0) {
         json_decref (jobentry);
-        goto nomem;
+        goto error;
     }
+    json_decref (jobentry);
     return 0;
-nomem:
-    errno = ENOMEM;
 error:
     saved_errno = errno;
     zlist_remove (batch->jobs, job);
-    if (make_key (key, sizeof (key), job, NULL) == 0)
-        (void)flux_kvs_txn_unlink (batch->txn, 0, key);
     errno = saved_errno;
     return -1;
 }
 
-static int ingest_add_job (struct job_ingest_ctx *ctx, struct job *job)
+/* Get the current "batch" of new jobs, creating the batch if one doesn't
+ * exist already and starting the batch timer.
+ */
+static struct batch *batch_get (struct job_ingest_ctx *ctx)
 {
-    if (fluid_generate (&ctx->gen, &job->id) < 0)
-        return -1;
-
-    /* Add job to the current "batch" of new jobs, creating the batch if
-     * one doesn't exist already.  Submit is finalized upon timer expiration.
-     */
     if (!ctx->batch) {
         if (!(ctx->batch = batch_create (ctx)))
-            return -1;
+            return NULL;
         if (!ctx->batch_count) {
-            flux_timer_watcher_reset (ctx->timer, batch_timeout, 0.);
+            flux_timer_watcher_reset (ctx->timer,
+                                      batch_window (&ctx->stats),
+                                      0.);
             flux_watcher_start (ctx->timer);
         }
     }
-    if (batch_add_job (ctx->batch, job) < 0)
-        return -1;
+    return ctx->batch;
+}
+
+/* Flush the current batch if it has reached the batch size limit.
+ */
+static void batch_check_limit (struct job_ingest_ctx *ctx)
+{
+    size_t size = json_array_size (ctx->batch->joblist);
 
-    if (ctx->batch_count
-        && zlist_size (ctx->batch->jobs) == ctx->batch_count)
+    if (ctx->batch_count) {
+        if (size >= ctx->batch_count)
+            batch_flush (ctx);
+    }
+    else if (size >= batch_limit (&ctx->stats)) {
+        flux_watcher_stop (ctx->timer);
         batch_flush (ctx);
+    }
+}
+
+static int ingest_add_job (struct job_ingest_ctx *ctx, struct job *job)
+{
+    struct batch *batch;
+
+    if (fluid_generate (&ctx->gen, &job->id) < 0)
+        return -1;
+
+    batch_stats_arrival (&ctx->stats);
+
+    /* Add job to the current batch.  Submit is finalized upon timer
+     * expiration, completion of the previous commit, or reaching the
+     * batch limit.
+     */
+    if (!(batch = batch_get (ctx))
+        || batch_add_job (batch, job) < 0)
+        return -1;
+    batch_check_limit (ctx);
     return 0;
 }
 
@@ -611,6 +1073,60 @@ error:
     flux_future_destroy (f);
 }
 
+/* Handle "job-ingest.relay" request from a downstream job-ingest, adding
+ * its already validated jobs to the current batch.  The response is sent
+ * once the batch has been committed or relayed further upstream.
+ */
+static void relay_cb (flux_t *h,
+                      flux_msg_handler_t *mh,
+                      const flux_msg_t *msg,
+                      void *arg)
+{
+    struct job_ingest_ctx *ctx = arg;
+    struct batch *batch = NULL;
+    struct relay *relay = NULL;
+    json_t *jobs;
+    json_t *entry;
+    size_t index;
+    size_t start = 0;
+
+    if (flux_request_unpack (msg, NULL, "{s:o}", "jobs", &jobs) < 0)
+        goto error;
+    if (!json_is_array (jobs) || json_array_size (jobs) == 0) {
+        errno = EPROTO;
+        goto error;
+    }
+    if (ctx->shutdown) {
+        errno = ENOSYS;
+        goto error;
+    }
+    if (!(relay = calloc (1, sizeof (*relay)))
+        || !(batch = batch_get (ctx)))
+        goto error;
+    start = json_array_size (batch->joblist);
+    json_array_foreach (jobs, index, entry) {
+        if (batch_add_entry (batch, entry) < 0)
+            goto error;
+    }
+    relay->msg = flux_msg_incref (msg);
+    relay->start = start;
+    relay->count = json_array_size (jobs);
+    if (zlist_append (batch->relays, relay) < 0) {
+        errno = ENOMEM;
+        goto error;
+    }
+    ctx->stats.relay_requests++;
+    ctx->stats.relay_jobs += relay->count;
+    batch_check_limit (ctx);
+    return;
+error:
+    if (batch)
+        batch_truncate (batch, start);
+    relay_destroy (relay);
+    if (flux_respond_error (h, msg, errno, NULL) < 0)
+        flux_log_error (h, "%s: flux_respond_error", __FUNCTION__);
+}
+
 /* Override built-in shutdown handler that calls flux_reactor_stop().
  * Since libsubprocess clients must run in reactive mode,
  * take care of cleaning up the pipeline before exiting reactor.
@@ -718,6 +1234,9 @@ static int job_ingest_configure (struct job_ingest_ctx *ctx,
         else if (streq (argv[i], "allow-root-jobs")) {
             allow_root_jobs = true;
         }
+        else if (streq (argv[i], "no-relay")) {
+            relay_disabled = true;
+        }
         else {
             errprintf (error, "Invalid option: %s", argv[i]);
             errno = EINVAL;
@@ -783,19 +1302,46 @@ static void stats_get_cb (flux_t *h,
                           void *arg)
 {
     struct job_ingest_ctx *ctx = arg;
+    struct batch_stats *stats = &ctx->stats;
     json_t *pstats = NULL;
+    json_t *size_hist = NULL;
+    json_t *latency_hist = NULL;
 
     if (flux_request_decode (msg, NULL, NULL) < 0)
         goto error;
+    if (!(size_hist = hist_encode (stats->size_hist))
+        || !(latency_hist = hist_encode (stats->latency_hist))) {
+        errno = ENOMEM;
+        goto error;
+    }
     pstats = pipeline_stats_get (ctx->pipeline);
     if (flux_respond_pack (h,
                            msg,
-                           "{s:O}",
-                           "pipeline", pstats) < 0)
+                           "{s:O s:{s:i s:f s:i s:f s:f s:O s:O}"
+                           " s:{s:b s:i s:i}}",
+                           "pipeline", pstats,
+                           "batch",
+                             "inflight", stats->inflight,
+                             "window", batch_window (stats),
+                             "limit", ctx->batch_count ?
+                                      ctx->batch_count : batch_limit (stats),
+                             "commit_latency", stats->commit_latency,
+                             "arrival_rate", stats->interarrival > 0. ?
+                                             1. / stats->interarrival : 0.,
+                             "size", size_hist,
+                             "latency", latency_hist,
+                           "relay",
+                             "enabled", ctx->relay,
+                             "requests", ctx->stats.relay_requests,
+                             "jobs", ctx->stats.relay_jobs) < 0)
         flux_log_error (h, "error responding to stats-get request");
     json_decref (pstats);
+    json_decref (size_hist);
+    json_decref (latency_hist);
     return;
 error:
+    json_decref (size_hist);
+    json_decref (latency_hist);
     if (flux_respond_error (h, msg, errno, NULL) < 0)
         flux_log_error (h, "error responding to stats-get request");
 }
@@ -804,6 +1350,7 @@ error:
 static const struct flux_msg_handler_spec htab[] = {
     { FLUX_MSGTYPE_REQUEST,  "job-ingest.getinfo", getinfo_cb, 0},
     { FLUX_MSGTYPE_REQUEST,  "job-ingest.submit", submit_cb, FLUX_ROLE_USER },
+    { FLUX_MSGTYPE_REQUEST,  "job-ingest.relay", relay_cb, 0 },
     { FLUX_MSGTYPE_REQUEST,  "job-ingest.shutdown", shutdown_cb, 0 },
     { FLUX_MSGTYPE_REQUEST,  "job-ingest.config-reload", reload_cb, 0 },
     { FLUX_MSGTYPE_REQUEST,  "job-ingest.stats-get",
@@ -935,6 +1482,7 @@ int mod_main (flux_t *h, int argc, char **argv)
             errno = EINVAL;
             goto done;
         }
+        ctx.relay = !relay_disabled;
     }
     flux_log (h, LOG_DEBUG, "fluid ts=%jums", (uintmax_t)ctx.gen.timestamp);
     if (flux_reactor_run (r, 0) < 0) {
@@ -22,6 +22,7 @@
 
 #include "util.h"
 #include "workcrew.h"
+#include "validate.h"
 #include "pipeline.h"
 
 struct pipeline {
@@ -31,7 +32,10 @@ struct pipeline {
     int process_count;
     flux_watcher_t *shutdown_timer;
     bool validator_bypass;
+    bool validator_native;
     bool frobnicate_enable;
+    int native_requests;
+    int native_errors;
 };
 
 static const char *cmd_validator = "job-validator";
@@ -88,6 +92,22 @@ static bool validator_bypass (struct pipeline *pl, struct job *job)
     return false;
 }
 
+/* When no validator plugins or arguments are configured, the validator
+ * would only run the default 'jobspec' plugin.  Apply the same checks
+ * in-process and avoid the validator subprocess altogether.
+ */
+static int validate_job_native (struct pipeline *pl,
+                                struct job *job,
+                                flux_error_t *error)
+{
+    pl->native_requests++;
+    if (validate_jobspec (job->jobspec, error) < 0) {
+        pl->native_errors++;
+        return -1;
+    }
+    return 0;
+}
+
 static flux_future_t *validate_job (struct pipeline *pl,
                                     struct job *job,
                                     flux_error_t *error)
@@ -150,7 +170,13 @@ static void frobnicate_continuation (flux_future_t *f1, void *arg)
     json_decref (job->jobspec);
     job->jobspec = jobspec;
 
-    if (!validator_bypass (pl, job)) {
+    if (!validator_bypass (pl, job) && pl->validator_native) {
+        if (validate_job_native (pl, job, &error) < 0) {
+            errmsg = error.text;
+            goto error;
+        }
+    }
+    else if (!validator_bypass (pl, job)) {
         flux_future_t *f2;
 
         if (!(f2 = validate_job (pl, job, &error))) {
@@ -199,6 +225,11 @@ int pipeline_process_job (struct pipeline *pl,
 
         if (validator_bypass (pl, job))
             *fp = NULL;
+        else if (pl->validator_native) {
+            if (validate_job_native (pl, job, error) < 0)
+                return -1;
+            *fp = NULL;
+        }
         else {
             if (!(f = validate_job (pl, job, error)))
                 return -1;
@@ -322,6 +353,7 @@ int pipeline_configure (struct pipeline *pl,
         else if (streq (argv[i], "disable-validator"))
             pl->validator_bypass = true;
     }
+    pl->validator_native = !validator_plugins && !validator_args;
 
     /* Enable the frobnicator if not bypassed AND either explicitly configured
      * or implicitly required by queues or jobspec defaults configuration.
@@ -389,9 +421,13 @@ json_t *pipeline_stats_get (struct pipeline *pl)
     if (pl) {
         json_t *fo = workcrew_stats_get (pl->frobnicate);
         json_t *vo = workcrew_stats_get (pl->validate);
-        o = json_pack ("{s:O s:O}",
+        o = json_pack ("{s:O s:O s:{s:b s:i s:i}}",
                        "frobnicator", fo,
-                       "validator", vo);
+                       "validator", vo,
+                       "native_validator",
+                         "enabled", pl->validator_native,
+                         "requests", pl->native_requests,
+                         "errors", pl->native_errors);
         json_decref (fo);
         json_decref (vo);
     }
@@ -418,6 +454,7 @@ struct pipeline *pipeline_create (flux_t *h)
     if (!(pl = calloc (1, sizeof (*pl))))
         return NULL;
     pl->h = h;
+    pl->validator_native = true;
     if (!(pl->shutdown_timer = flux_timer_watcher_create (r,
                                                           0.,
                                                           0.,
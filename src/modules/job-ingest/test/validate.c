@@ -0,0 +1,194 @@
+/************************************************************\
+ * Copyright 2026 Lawrence Livermore National Security, LLC
+ * (c.f. AUTHORS, NOTICE.LLNS, COPYING)
+ *
+ * This file is part of the Flux resource manager framework.
+ * For details, see https://github.com/flux-framework.
+ *
+ * SPDX-License-Identifier: LGPL-3.0
+\************************************************************/
+
+#if HAVE_CONFIG_H
+#include "config.h"
+#endif
+#include <jansson.h>
+#include <string.h>
+#include <errno.h>
+#include <flux/core.h>
+
+#include "src/common/libtap/tap.h"
+#include "ccan/str/str.h"
+
+#include "validate.h"
+
+#define RES_SLOT "[{\"type\":\"slot\",\"count\":1,\"label\":\"task\"," \
+                 "\"with\":[{\"type\":\"core\",\"count\":1}]}]"
+#define TASKS "[{\"command\":[\"true\"],\"slot\":\"task\"," \
+              "\"count\":{\"per_slot\":1}}]"
+#define ATTRS "{\"system\":{\"duration\":0}}"
+
+struct validate_test {
+    const char *jobspec;
+    const char *errstr;     // NULL if valid
+};
+
+struct validate_test tests[] = {
+    { "{\"resources\":" RES_SLOT ",\"tasks\":" TASKS
+      ",\"attributes\":" ATTRS ",\"version\":1}",
+      NULL,
+    },
+    { "{\"resources\":[{\"type\":\"node\",\"count\":2,\"exclusive\":true,"
+      "\"with\":[{\"type\":\"slot\",\"count\":1,\"label\":\"task\","
+      "\"with\":[{\"type\":\"core\",\"count\":4},"
+      "{\"type\":\"gpu\",\"count\":0}]}]}]"
+      ",\"tasks\":[{\"command\":[\"a\",\"b\"],\"slot\":\"task\","
+      "\"count\":{\"total\":2}}]"
+      ",\"attributes\":{\"system\":{\"duration\":3.5,"
+      "\"dependencies\":[{\"scheme\":\"afterok\",\"value\":\"f1\"}],"
+      "\"constraints\":{\"and\":[{\"properties\":[\"foo\"]},"
+      "{\"hostlist\":[\"host[0-3]\"]},{\"ranks\":[\"0-1\"]}]}},"
+      "\"user\":{\"x\":1}},\"version\":1}",
+      NULL,
+    },
+    { "{\"resources\":[{\"type\":\"slot\",\"count\":{\"min\":1},"
+      "\"label\":\"task\",\"with\":[{\"type\":\"core\",\"count\":"
+      "{\"min\":1,\"max\":4,\"operator\":\"+\",\"operand\":1}}]}]"
+      ",\"tasks\":" TASKS ",\"attributes\":" ATTRS ",\"version\":1}",
+      NULL,
+    },
+    { "{\"tasks\":" TASKS ",\"attributes\":" ATTRS ",\"version\":1}",
+      "Missing key (resources)",
+    },
+    { "{\"resources\":" RES_SLOT ",\"tasks\":" TASKS
+      ",\"attributes\":" ATTRS ",\"version\":1,\"foo\":1}",
+      "Extraneous key (foo)",
+    },
+    { "{\"resources\":" RES_SLOT ",\"tasks\":" TASKS
+      ",\"attributes\":" ATTRS ",\"version\":2}",
+      "version must be 1",
+    },
+    { "{\"resources\":{},\"tasks\":" TASKS
+      ",\"attributes\":" ATTRS ",\"version\":1}",
+      "resources must be a sequence",
+    },
+    { "{\"resources\":[{\"type\":\"slot\",\"count\":1}],\"tasks\":" TASKS
+      ",\"attributes\":" ATTRS ",\"version\":1}",
+      "slots must have labels",
+    },
+    { "{\"resources\":[{\"type\":\"node\",\"count\":0}],\"tasks\":" TASKS
+      ",\"attributes\":" ATTRS ",\"version\":1}",
+      "node or slot count must be > 0",
+    },
+    { "{\"resources\":[{\"type\":\"slot\",\"count\":{\"min\":1,\"max\":2},"
+      "\"label\":\"task\"}],\"tasks\":" TASKS
+      ",\"attributes\":" ATTRS ",\"version\":1}",
+      "Missing key (operator)",
+    },
+    { "{\"resources\":" RES_SLOT ",\"tasks\":[{\"command\":[],"
+      "\"slot\":\"task\",\"count\":{\"per_slot\":1}}]"
+      ",\"attributes\":" ATTRS ",\"version\":1}",
+      "command array cannot have length of zero",
+    },
+    { "{\"resources\":" RES_SLOT ",\"tasks\":[{\"command\":\"true\","
+      "\"slot\":\"task\",\"count\":{\"per_slot\":1}}]"
+      ",\"attributes\":" ATTRS ",\"version\":1}",
+      "command must be a list of strings",
+    },
+    { "{\"resources\":" RES_SLOT ",\"tasks\":[{\"command\":[\"true\"],"
+      "\"slot\":\"task\",\"count\":{\"per_resource\":1}}]"
+      ",\"attributes\":" ATTRS ",\"version\":1}",
+      "count per_slot or total must be set",
+    },
+    { "{\"resources\":" RES_SLOT ",\"tasks\":[{\"command\":[\"true\"],"
+      "\"slot\":\"task\",\"count\":{\"total\":0}}]"
+      ",\"attributes\":" ATTRS ",\"version\":1}",
+      "count total must be > 0",
+    },
+    { "{\"resources\":" RES_SLOT ",\"tasks\":" TASKS
+      ",\"attributes\":{\"system\":{\"duration\":0},\"foo\":{}}"
+      ",\"version\":1}",
+      "Extraneous key (foo)",
+    },
+    { "{\"resources\":" RES_SLOT ",\"tasks\":" TASKS
+      ",\"attributes\":{\"user\":{}},\"version\":1}",
+      "attributes.system is a required key",
+    },
+    { "{\"resources\":" RES_SLOT ",\"tasks\":" TASKS
+      ",\"attributes\":{\"system\":{}},\"version\":1}",
+      "attributes.system.duration is a required key",
+    },
+    { "{\"resources\":" RES_SLOT ",\"tasks\":" TASKS
+      ",\"attributes\":{\"system\":{\"duration\":\"1m\"}},\"version\":1}",
+      "attributes.system.duration must be a number",
+    },
+    { "{\"resources\":" RES_SLOT ",\"tasks\":" TASKS
+      ",\"attributes\":{\"system\":{\"duration\":0,"
+      "\"dependencies\":[{\"scheme\":\"afterok\"}]}},\"version\":1}",
+      "Missing key (value)",
+    },
+    { "{\"resources\":" RES_SLOT ",\"tasks\":" TASKS
+      ",\"attributes\":{\"system\":{\"duration\":0,"
+      "\"constraints\":{\"foo\":[\"bar\"]}}},\"version\":1}",
+      "unknown constraint operator 'foo'",
+    },
+    { "{\"resources\":" RES_SLOT ",\"tasks\":" TASKS
+      ",\"attributes\":{\"system\":{\"duration\":0,"
+      "\"constraints\":{\"not\":[{\"hostlist\":[\"f[\"]}]}}},"
+      "\"version\":1}",
+      "Invalid hostlist: 'f['",
+    },
+    { "{\"resources\":" RES_SLOT ",\"tasks\":" TASKS
+      ",\"attributes\":{\"system\":{\"duration\":0,"
+      "\"constraints\":{\"ranks\":[\"1-0\"]}}},\"version\":1}",
+      "IDset(): Invalid argument: 1-0",
+    },
+    { "{\"resources\":" RES_SLOT ",\"tasks\":" TASKS
+      ",\"attributes\":{\"system\":{\"duration\":0,"
+      "\"constraints\":{\"properties\":[\"a|b\"]}}},\"version\":1}",
+      "invalid character in property 'a|b'",
+    },
+    { NULL, NULL },
+};
+
+void test_validate (void)
+{
+    for (int i = 0; tests[i].jobspec != NULL; i++) {
+        json_t *o;
+        flux_error_t error;
+        int rc;
+
+        if (!(o = json_loads (tests[i].jobspec, 0, NULL)))
+            BAIL_OUT ("failed to decode test jobspec %d", i);
+        memset (&error, 0, sizeof (error));
+        errno = 0;
+        rc = validate_jobspec (o, &error);
+        if (tests[i].errstr == NULL) {
+            ok (rc == 0,
+                "validate_jobspec accepts valid jobspec %d", i);
+            if (rc < 0)
+                diag ("%s", error.text);
+        }
+        else {
+            ok (rc < 0 && errno == EINVAL
+                && streq (error.text, tests[i].errstr),
+                "validate_jobspec rejects jobspec %d: %s",
+                i,
+                tests[i].errstr);
+            if (rc == 0 || !streq (error.text, tests[i].errstr))
+                diag ("got: %s", rc < 0 ? error.text : "success");
+        }
+        json_decref (o);
+    }
+}
+
+int main (int argc, char *argv[])
+{
+    plan (NO_PLAN);
+
+    test_validate ();
+
+    done_testing ();
+    return 0;
+}
+
+// vi:ts=4 sw=4 expandtab
@@ -0,0 +1,438 @@
+/************************************************************\
+ * Copyright 2026 Lawrence Livermore National Security, LLC
+ * (c.f. AUTHORS, NOTICE.LLNS, COPYING)
+ *
+ * This file is part of the Flux resource manager framework.
+ * For details, see https://github.com/flux-framework.
+ *
+ * SPDX-License-Identifier: LGPL-3.0
+\************************************************************/
+
+/* validate.c - in-process V1 jobspec validation
+ *
+ * This mirrors the checks made by flux.job.validate_jobspec() in the
+ * Python bindings, as used by the default job-validator 'jobspec' plugin,
+ * and produces the same error messages.  It lets job-ingest skip the
+ * validator subprocess when no other validator plugins are configured.
+ *
+ * Any change to the Python validation should be reflected here.
+ */
+
+#if HAVE_CONFIG_H
+#include "config.h"
+#endif
+#include <errno.h>
+#include <stdarg.h>
+#include <string.h>
+#include <jansson.h>
+#include <flux/core.h>
+
+#include "src/common/libutil/errprintf.h"
+#include "src/common/libhostlist/hostlist.h"
+#include "src/common/libidset/idset.h"
+#include "ccan/str/str.h"
+
+#include "validate.h"
+
+static int invalid (flux_error_t *error, const char *fmt, ...)
+    __attribute__ ((format (printf, 2, 3)));
+
+static int invalid (flux_error_t *error, const char *fmt, ...)
+{
+    va_list ap;
+
+    va_start (ap, fmt);
+    verrprintf (error, fmt, ap);
+    va_end (ap);
+    errno = EINVAL;
+    return -1;
+}
+
+/* Python's isinstance (x, int) is also true for booleans.
+ */
+static bool is_int (json_t *o)
+{
+    return json_is_integer (o) || json_is_boolean (o);
+}
+
+static json_int_t int_value (json_t *o)
+{
+    if (json_is_boolean (o))
+        return json_is_true (o) ? 1 : 0;
+    return json_integer_value (o);
+}
+
+/* Check that all 'keys' (NULL terminated) are present in object 'o'
+ * unless 'optional' is true, and unless 'additional' is true, that 'o'
+ * has no other keys.
+ */
+static int validate_keys (json_t *o,
+                          const char **keys,
+                          bool optional,
+                          bool additional,
+                          flux_error_t *error)
+{
+    const char *key;
+    json_t *value;
+
+    if (!optional) {
+        for (int i = 0; keys[i] != NULL; i++) {
+            if (!json_object_get (o, keys[i]))
+                return invalid (error, "Missing key (%s)", keys[i]);
+        }
+    }
+    if (!additional) {
+        json_object_foreach (o, key, value) {
+            int i;
+            for (i = 0; keys[i] != NULL; i++) {
+                if (streq (key, keys[i]))
+                    break;
+            }
+            if (keys[i] == NULL)
+                return invalid (error, "Extraneous key (%s)", key);
+        }
+    }
+    return 0;
+}
+
+static int validate_complex_range (json_t *range, flux_error_t *error)
+{
+    const char *keys[] = { "min", "max", "operator", "operand", NULL };
+    const char *intkeys[] = { "min", "max", "operand", NULL };
+    json_t *op;
+
+    if (!json_object_get (range, "min"))
+        return invalid (error, "min must be in range");
+    if (json_object_size (range) > 1
+        && validate_keys (range, keys, false, false, error) < 0)
+        return -1;
+    for (int i = 0; intkeys[i] != NULL; i++) {
+        json_t *value;
+
+        if (!(value = json_object_get (range, intkeys[i])))
+            continue;
+        if (!is_int (value))
+            return invalid (error, "%s must be an int", intkeys[i]);
+        if (int_value (value) < 1)
+            return invalid (error, "%s must be > 0", intkeys[i]);
+    }
+    if ((op = json_object_get (range, "operator"))) {
+        const char *s = json_string_value (op);
+        if (!s || !(streq (s, "+") || streq (s, "*") || streq (s, "^")))
+            return invalid (error,
+                            "operator must be one of ['+', '*', '^']");
+    }
+    return 0;
+}
+
+static int validate_resource (json_t *res, flux_error_t *error)
+{
+    const char *strkeys[] = { "id", "unit", "label", NULL };
+    json_t *type;
+    json_t *count;
+    json_t *exclusive;
+    const char *s;
+
+    if (!json_is_object (res))
+        return invalid (error, "resource must be a mapping");
+    if (!(type = json_object_get (res, "type")))
+        return invalid (error, "type is a required key for resources");
+    if (!(s = json_string_value (type)))
+        return invalid (error, "type must be a string");
+    if (!(count = json_object_get (res, "count")))
+        return invalid (error, "count is a required key for resources");
+    if (json_is_object (count)) {
+        if (validate_complex_range (count, error) < 0)
+            return -1;
+    }
+    else if (!is_int (count))
+        return invalid (error, "count must be an int or mapping");
+    else {
+        /* node, slot, and core must have count > 0, but allow 0 for
+         * any other resource type.
+         */
+        if ((streq (s, "node") || streq (s, "slot") || streq (s, "core"))
+            && int_value (count) < 1)
+            return invalid (error, "node or slot count must be > 0");
+        if (int_value (count) < 0)
+            return invalid (error, "count must be >= 0");
+    }
+    for (int i = 0; strkeys[i] != NULL; i++) {
+        json_t *value = json_object_get (res, strkeys[i]);
+        if (value && !json_is_string (value))
+            return invalid (error, "%s must be a string", strkeys[i]);
+    }
+    if ((exclusive = json_object_get (res, "exclusive"))) {
+        if (!is_int (exclusive)
+            || (int_value (exclusive) != 0 && int_value (exclusive) != 1))
+            return invalid (error, "exclusive must be a boolean");
+    }
+    if (streq (s, "slot") && !json_object_get (res, "label"))
+        return invalid (error, "slots must have labels");
+    return 0;
+}
+
+/* Validate each resource in a depth-first, pre-order traversal.
+ */
+static int validate_resources (json_t *resources, flux_error_t *error)
+{
+    size_t index;
+    json_t *res;
+
+    json_array_foreach (resources, index, res) {
+        json_t *with;
+
+        if (validate_resource (res, error) < 0)
+            return -1;
+        if ((with = json_object_get (res, "with"))) {
+            if (!json_is_array (with))
+                return invalid (error, "resource must be a mapping");
+            if (validate_resources (with, error) < 0)
+                return -1;
+        }
+    }
+    return 0;
+}
+
+static int validate_task_count (json_t *count,
+                                const char *name,
+                                flux_error_t *error)
+{
+    json_t *value;
+
+    if (!(value = json_object_get (count, name)))
+        return 0;
+    if (!is_int (value))
+        return invalid (error, "count %s must be an int", name);
+    if (int_value (value) <= 0)
+        return invalid (error, "count %s must be > 0", name);
+    return 0;
+}
+
+static int validate_task (json_t *task, flux_error_t *error)
+{
+    const char *keys[] = { "command", "slot", "count", NULL };
+    json_t *count;
+    json_t *attributes;
+    json_t *command;
+    size_t index;
+    json_t *arg;
+
+    if (!json_is_object (task))
+        return invalid (error, "task must be a mapping");
+    if (validate_keys (task, keys, false, true, error) < 0)
+        return -1;
+    count = json_object_get (task, "count");
+    if (!json_is_object (count))
+        return invalid (error, "count must be a mapping");
+    if (json_object_size (count) != 1)
+        return invalid (error, "count must have exactly one key set");
+    if (!json_object_get (count, "per_slot")
+        && !json_object_get (count, "per_resource")
+        && !json_object_get (count, "total"))
+        return invalid (error,
+                        "count per_slot, per_resource, or total must be set");
+    if (validate_task_count (count, "total", error) < 0
+        || validate_task_count (count, "per_slot", error) < 0)
+        return -1;
+    if (!json_is_string (json_object_get (task, "slot")))
+        return invalid (error, "slot must be a string");
+    if ((attributes = json_object_get (task, "attributes"))
+        && !json_is_object (attributes))
+        return invalid (error, "count must be a mapping");
+    command = json_object_get (task, "command");
+    if ((json_is_array (command) && json_array_size (command) == 0)
+        || (json_is_string (command) && json_string_length (command) == 0))
+        return invalid (error, "command array cannot have length of zero");
+    if (!json_is_array (command))
+        return invalid (error, "command must be a list of strings");
+    json_array_foreach (command, index, arg) {
+        if (!json_is_string (arg))
+            return invalid (error, "command must be a list of strings");
+    }
+    return 0;
+}
+
+static int validate_dependency (json_t *dep, flux_error_t *error)
+{
+    const char *keys[] = { "scheme", "value", NULL };
+
+    if (!json_is_object (dep))
+        return invalid (error, "dependency must be a mapping");
+    if (validate_keys (dep, keys, false, true, error) < 0)
+        return -1;
+    if (!json_is_string (json_object_get (dep, "scheme")))
+        return invalid (error, "dependency scheme must be a string");
+    if (!json_is_string (json_object_get (dep, "value")))
+        return invalid (error, "dependency value must be a string");
+    return 0;
+}
+
+static int validate_constraint (json_t *constraint, flux_error_t *error);
+
+static int validate_constraint_op (const char *op,
+                                   json_t *args,
+                                   flux_error_t *error)
+{
+    size_t index;
+    json_t *arg;
+
+    if (!json_is_array (args))
+        return invalid (error,
+                        "argument to constraint %s must be a sequence",
+                        op);
+    if (streq (op, "and") || streq (op, "or") || streq (op, "not")) {
+        json_array_foreach (args, index, arg) {
+            if (validate_constraint (arg, error) < 0)
+                return -1;
+        }
+    }
+    else if (streq (op, "properties")) {
+        json_array_foreach (args, index, arg) {
+            const char *name = json_string_value (arg);
+            if (!name)
+                return invalid (error, "property must be a string");
+            if (strpbrk (name, "&'\"`|()"))
+                return invalid (error,
+                                "invalid character in property '%s'",
+                                name);
+        }
+    }
+    else if (streq (op, "hostlist")) {
+        json_array_foreach (args, index, arg) {
+            const char *hosts = json_string_value (arg);
+            struct hostlist *hl;
+            if (!hosts || !(hl = hostlist_decode (hosts)))
+                return invalid (error,
+                                "Invalid hostlist: '%s'",
+                                hosts ? hosts : "");
+            hostlist_destroy (hl);
+        }
+    }
+    else if (streq (op, "ranks")) {
+        json_array_foreach (args, index, arg) {
+            const char *ranks = json_string_value (arg);
+            struct idset *ids;
+            if (!ranks || !(ids = idset_decode (ranks)))
+                return invalid (error,
+                                "IDset(): Invalid argument: %s",
+                                ranks ? ranks : "");
+            idset_destroy (ids);
+        }
+    }
+    else
+        return invalid (error, "unknown constraint operator '%s'", op);
+    return 0;
+}
+
+static int validate_constraint (json_t *constraint, flux_error_t *error)
+{
+    const char *op;
+    json_t *args;
+
+    if (!json_is_object (constraint))
+        return invalid (error, "constraints must be a mapping");
+    json_object_foreach (constraint, op, args) {
+        if (validate_constraint_op (op, args, error) < 0)
+            return -1;
+    }
+    return 0;
+}
+
+static int validate_system_attributes (json_t *system, flux_error_t *error)
+{
+    json_t *deps;
+    json_t *constraints;
+
+    if (!json_is_object (system))
+        return 0;
+    if ((deps = json_object_get (system, "dependencies"))) {
+        size_t index;
+        json_t *dep;
+
+        if (!json_is_array (deps))
+            return invalid (error,
+                            "attributes.system.dependencies must be a list");
+        json_array_foreach (deps, index, dep) {
+            if (validate_dependency (dep, error) < 0)
+                return -1;
+        }
+    }
+    if ((constraints = json_object_get (system, "constraints"))
+        && validate_constraint (constraints, error) < 0)
+        return -1;
+    return 0;
+}
+
+/* Requirements specific to V1 jobspec.
+ */
+static int validate_v1 (json_t *tasks,
+                        json_t *attributes,
+                        flux_error_t *error)
+{
+    json_t *system;
+    json_t *duration;
+    size_t index;
+    json_t *task;
+
+    if (!(system = json_object_get (attributes, "system")))
+        return invalid (error, "attributes.system is a required key");
+    if (!json_is_object (system))
+        return invalid (error, "attributes.system must be a mapping");
+    if (!(duration = json_object_get (system, "duration")))
+        return invalid (error, "attributes.system.duration is a required key");
+    if (!json_is_number (duration) && !json_is_boolean (duration))
+        return invalid (error, "attributes.system.duration must be a number");
+    json_array_foreach (tasks, index, task) {
+        json_t *count = json_object_get (task, "count");
+        if (!json_object_get (count, "per_slot")
+            && !json_object_get (count, "total"))
+            return invalid (error, "count per_slot or total must be set");
+    }
+    return 0;
+}
+
+int validate_jobspec (json_t *jobspec, flux_error_t *error)
+{
+    const char *keys[] = { "resources", "tasks", "version", "attributes",
+                           NULL };
+    const char *attr_keys[] = { "system", "user", NULL };
+    json_t *resources;
+    json_t *tasks;
+    json_t *version;
+    json_t *attributes;
+    size_t index;
+    json_t *task;
+
+    if (!json_is_object (jobspec))
+        return invalid (error, "jobspec must be a mapping");
+    if (validate_keys (jobspec, keys, false, false, error) < 0)
+        return -1;
+    resources = json_object_get (jobspec, "resources");
+    tasks = json_object_get (jobspec, "tasks");
+    version = json_object_get (jobspec, "version");
+    attributes = json_object_get (jobspec, "attributes");
+
+    if (!is_int (version) || int_value (version) != 1)
+        return invalid (error, "version must be 1");
+    if (!json_is_array (resources))
+        return invalid (error, "resources must be a sequence");
+    if (!json_is_array (tasks))
+        return invalid (error, "tasks must be a sequence");
+    if (!json_is_object (attributes))
+        return invalid (error, "attributes must be a mapping");
+    if (validate_resources (resources, error) < 0)
+        return -1;
+    json_array_foreach (tasks, index, task) {
+        if (validate_task (task, error) < 0)
+            return -1;
+    }
+    if (validate_keys (attributes, attr_keys, true, false, error) < 0)
+        return -1;
+    if (validate_system_attributes (json_object_get (attributes, "system"),
+                                    error) < 0)
+        return -1;
+    return validate_v1 (tasks, attributes, error);
+}
+
+// vi:ts=4 sw=4 expandtab
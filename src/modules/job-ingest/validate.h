@@ -0,0 +1,26 @@
+/************************************************************\
+ * Copyright 2026 Lawrence Livermore National Security, LLC
+ * (c.f. AUTHORS, NOTICE.LLNS, COPYING)
+ *
+ * This file is part of the Flux resource manager framework.
+ * For details, see https://github.com/flux-framework.
+ *
+ * SPDX-License-Identifier: LGPL-3.0
+\************************************************************/
+
+#ifndef _JOB_INGEST_VALIDATE_H_
+#define _JOB_INGEST_VALIDATE_H_
+
+#include <jansson.h>
+#include <flux/core.h>
+
+/* Validate V1 jobspec in-process, applying the same checks as the
+ * default job-validator 'jobspec' plugin with --require-version=1.
+ * Returns 0 on success, or -1 with errno set to EINVAL and a message
+ * in 'error' on failure.
+ */
+int validate_jobspec (json_t *jobspec, flux_error_t *error);
+
+#endif /* !_JOB_INGEST_VALIDATE_H */
+
+// vi:ts=4 sw=4 expandtab
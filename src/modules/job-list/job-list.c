@@ -95,6 +95,7 @@ static void purge_cb (flux_t *h,
             if (job->state != FLUX_JOB_STATE_INACTIVE)
                 continue;
             job_stats_purge (ctx->jsctx->statsctx, job);
+            job_state_index_remove (ctx->jsctx, job);
             if (job->list_handle)
                 zlistx_delete (ctx->jsctx->inactive, job->list_handle);
             zhashx_delete (ctx->jsctx->index, &id);
@@ -122,6 +123,7 @@ static void disconnect_cb (flux_t *h,
 {
     struct list_ctx *ctx = arg;
     job_stats_disconnect (ctx->jsctx->statsctx, msg);
+    list_stream_disconnect (ctx->lsctx, msg);
 }
 
 static void config_reload_cb (flux_t *h,
@@ -158,6 +160,11 @@ static const struct flux_msg_handler_spec htab[] = {
       .cb           = list_cb,
       .rolemask     = FLUX_ROLE_USER
     },
+    { .typemask     = FLUX_MSGTYPE_REQUEST,
+      .topic_glob   = "job-list.list-cancel",
+      .cb           = list_cancel_cb,
+      .rolemask     = FLUX_ROLE_USER
+    },
     { .typemask     = FLUX_MSGTYPE_REQUEST,
       .topic_glob   = "job-list.list-id",
       .cb           = list_id_cb,
@@ -208,6 +215,7 @@ static void list_ctx_destroy (struct list_ctx *ctx)
         int saved_errno = errno;
         flux_msg_handler_delvec (ctx->handlers);
         flux_msglist_destroy (ctx->deferred_requests);
+        list_stream_ctx_destroy (ctx->lsctx);
         if (ctx->jsctx)
             job_state_destroy (ctx->jsctx);
         if (ctx->isctx)
@@ -235,6 +243,8 @@ static struct list_ctx *list_ctx_create (flux_t *h)
         goto error;
     if (!(ctx->deferred_requests = flux_msglist_create ()))
         goto error;
+    if (!(ctx->lsctx = list_stream_ctx_create (ctx->h, ctx->jsctx)))
+        goto error;
     if (!(ctx->mctx = match_ctx_create (ctx->h)))
         goto error;
     return ctx;
@@ -254,6 +264,8 @@ int mod_main (flux_t *h, int argc, char **argv)
     }
     if (flux_reactor_run (flux_get_reactor (h), 0) < 0)
         goto done;
+    if (job_state_checkpoint (ctx->jsctx) < 0)
+        flux_log_error (h, "error saving checkpoint");
     rc = 0;
 done:
     list_ctx_destroy (ctx);
@@ -26,6 +26,7 @@ struct list_ctx {
     struct idsync_ctx *isctx;
     struct flux_msglist *deferred_requests;
     struct match_ctx *mctx;
+    struct list_stream_ctx *lsctx;
 };
 
 const char **job_attrs (void);
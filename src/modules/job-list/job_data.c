@@ -24,15 +24,36 @@
 #include "src/common/libjob/jj.h"
 #include "src/common/libjob/idf58.h"
 #include "src/common/libutil/jpath.h"
+#include "ccan/array_size/array_size.h"
 #include "ccan/str/str.h"
 
 #include "job_data.h"
 
+struct job_strpool {
+    zhashx_t *strings;
+};
+
+struct strpool_entry {
+    int refcount;
+    char s[];
+};
+
+static void strpool_release (struct job_strpool *sp, const char *s);
+
 void job_destroy (void *data)
 {
     struct job *job = data;
     if (job) {
         int save_errno = errno;
+        if (job->strpool) {
+            strpool_release (job->strpool, job->name);
+            strpool_release (job->strpool, job->queue);
+            strpool_release (job->strpool, job->cwd);
+            strpool_release (job->strpool, job->project);
+            strpool_release (job->strpool, job->bank);
+            strpool_release (job->strpool, job->exception_type);
+            strpool_release (job->strpool, job->exception_note);
+        }
         free (job->ranks);
         free (job->nodelist);
         hostlist_destroy (job->nodelist_hl);
@@ -546,6 +567,284 @@ int job_R_update (struct job *job, json_t *updates)
     return parse_R (job, false);
 }
 
+static void strpool_entry_destructor (void **item)
+{
+    if (item) {
+        free (*item);
+        *item = NULL;
+    }
+}
+
+struct job_strpool *job_strpool_create (void)
+{
+    struct job_strpool *sp;
+
+    if (!(sp = calloc (1, sizeof (*sp))))
+        return NULL;
+    if (!(sp->strings = zhashx_new ())) {
+        free (sp);
+        errno = ENOMEM;
+        return NULL;
+    }
+    /* keys point into entries, so are not duplicated or freed
+     */
+    zhashx_set_key_duplicator (sp->strings, NULL);
+    zhashx_set_key_destructor (sp->strings, NULL);
+    zhashx_set_destructor (sp->strings, strpool_entry_destructor);
+    return sp;
+}
+
+void job_strpool_destroy (struct job_strpool *sp)
+{
+    if (sp) {
+        int saved_errno = errno;
+        zhashx_destroy (&sp->strings);
+        free (sp);
+        errno = saved_errno;
+    }
+}
+
+static const char *strpool_intern (struct job_strpool *sp, const char *s)
+{
+    struct strpool_entry *e;
+
+    if (!(e = zhashx_lookup (sp->strings, s))) {
+        size_t len = strlen (s);
+        if (!(e = malloc (sizeof (*e) + len + 1)))
+            return NULL;
+        e->refcount = 0;
+        memcpy (e->s, s, len + 1);
+        if (zhashx_insert (sp->strings, e->s, e) < 0) {
+            free (e);
+            errno = ENOMEM;
+            return NULL;
+        }
+    }
+    e->refcount++;
+    return e->s;
+}
+
+static void strpool_release (struct job_strpool *sp, const char *s)
+{
+    struct strpool_entry *e;
+
+    if (s && (e = zhashx_lookup (sp->strings, s)) && --e->refcount == 0)
+        zhashx_delete (sp->strings, s);
+}
+
+int job_compact (struct job *job, struct job_strpool *sp)
+{
+    const char **fields[] = {
+        &job->name,
+        &job->queue,
+        &job->cwd,
+        &job->project,
+        &job->bank,
+        &job->exception_type,
+        &job->exception_note,
+    };
+    const int nfields = ARRAY_SIZE (fields);
+    const char *interned[ARRAY_SIZE (fields)];
+    int n;
+
+    if (!job || !sp) {
+        errno = EINVAL;
+        return -1;
+    }
+    if (job->strpool)
+        return 0;
+    for (n = 0; n < nfields; n++) {
+        interned[n] = NULL;
+        if (*fields[n] && !(interned[n] = strpool_intern (sp, *fields[n])))
+            goto error;
+    }
+    for (int i = 0; i < nfields; i++)
+        *fields[i] = interned[i];
+    job->strpool = sp;
+
+    json_decref (job->jobspec);
+    job->jobspec = NULL;
+    json_decref (job->R);
+    job->R = NULL;
+    json_decref (job->exception_context);
+    job->exception_context = NULL;
+    hostlist_destroy (job->nodelist_hl);
+    job->nodelist_hl = NULL;
+    idset_destroy (job->ranks_idset);
+    job->ranks_idset = NULL;
+    return 0;
+error:
+    while (--n >= 0)
+        strpool_release (sp, interned[n]);
+    return -1;
+}
+
+static int object_set_string (json_t *o, const char *key, const char *s)
+{
+    json_t *val;
+
+    if (!s)
+        return 0;
+    if (!(val = json_string (s)) || json_object_set_new (o, key, val) < 0) {
+        json_decref (val);
+        return -1;
+    }
+    return 0;
+}
+
+json_t *job_snapshot (struct job *job)
+{
+    json_t *o;
+
+    if (!job || job->state != FLUX_JOB_STATE_INACTIVE) {
+        errno = EINVAL;
+        return NULL;
+    }
+    if (!(o = json_pack ("{s:I s:I s:i s:I s:f s:f s:f s:f s:f s:i s:i s:f"
+                         " s:i s:f s:i s:b s:b s:i s:i s:i s:i s:i}",
+                         "id", (json_int_t) job->id,
+                         "userid", (json_int_t) job->userid,
+                         "urgency", job->urgency,
+                         "priority", (json_int_t) job->priority,
+                         "t_submit", job->t_submit,
+                         "t_depend", job->t_depend,
+                         "t_run", job->t_run,
+                         "t_cleanup", job->t_cleanup,
+                         "t_inactive", job->t_inactive,
+                         "ntasks", job->ntasks,
+                         "ncores", job->ncores,
+                         "duration", job->duration,
+                         "nnodes", job->nnodes,
+                         "expiration", job->expiration,
+                         "waitstatus", job->wait_status,
+                         "success", job->success ? 1 : 0,
+                         "exception_occurred", job->exception_occurred ? 1 : 0,
+                         "exception_severity", job->exception_severity,
+                         "result", job->result,
+                         "states_mask", job->states_mask,
+                         "states_events_mask", job->states_events_mask,
+                         "submit_version", job->submit_version)))
+        goto nomem;
+    if (object_set_string (o, "name", job->name) < 0
+        || object_set_string (o, "queue", job->queue) < 0
+        || object_set_string (o, "cwd", job->cwd) < 0
+        || object_set_string (o, "project", job->project) < 0
+        || object_set_string (o, "bank", job->bank) < 0
+        || object_set_string (o, "exception_type", job->exception_type) < 0
+        || object_set_string (o, "exception_note", job->exception_note) < 0
+        || object_set_string (o, "ranks", job->ranks) < 0
+        || object_set_string (o, "nodelist", job->nodelist) < 0)
+        goto nomem;
+    if (job->annotations
+        && json_object_set (o, "annotations", job->annotations) < 0)
+        goto nomem;
+    if (job->dependencies
+        && json_object_set (o,
+                            "dependencies",
+                            grudgeset_tojson (job->dependencies)) < 0)
+        goto nomem;
+    return o;
+nomem:
+    json_decref (o);
+    errno = ENOMEM;
+    return NULL;
+}
+
+struct job *job_create_from_snapshot (flux_t *h,
+                                      json_t *o,
+                                      struct job_strpool *sp)
+{
+    struct job *job;
+    json_int_t id;
+    json_int_t userid;
+    json_int_t priority;
+    int success;
+    int exception_occurred;
+    int result;
+    const char *ranks = NULL;
+    const char *nodelist = NULL;
+    json_t *annotations = NULL;
+    json_t *dependencies = NULL;
+    size_t index;
+    json_t *entry;
+
+    if (!o || !sp) {
+        errno = EINVAL;
+        return NULL;
+    }
+    if (json_unpack (o, "{s:I}", "id", &id) < 0) {
+        errno = EPROTO;
+        return NULL;
+    }
+    if (!(job = job_create (h, id)))
+        return NULL;
+    if (json_unpack (o,
+                     "{s:I s:i s:I s:F s:F s:F s:F s:F s:i s:i s:F"
+                     " s:i s:F s:i s:b s:b s:i s:i s:i s:i s:i"
+                     " s?s s?s s?s s?s s?s s?s s?s s?s s?s s?o s?o}",
+                     "userid", &userid,
+                     "urgency", &job->urgency,
+                     "priority", &priority,
+                     "t_submit", &job->t_submit,
+                     "t_depend", &job->t_depend,
+                     "t_run", &job->t_run,
+                     "t_cleanup", &job->t_cleanup,
+                     "t_inactive", &job->t_inactive,
+                     "ntasks", &job->ntasks,
+                     "ncores", &job->ncores,
+                     "duration", &job->duration,
+                     "nnodes", &job->nnodes,
+                     "expiration", &job->expiration,
+                     "waitstatus", &job->wait_status,
+                     "success", &success,
+                     "exception_occurred", &exception_occurred,
+                     "exception_severity", &job->exception_severity,
+                     "result", &result,
+                     "states_mask", &job->states_mask,
+                     "states_events_mask", &job->states_events_mask,
+                     "submit_version", &job->submit_version,
+                     "name", &job->name,
+                     "queue", &job->queue,
+                     "cwd", &job->cwd,
+                     "project", &job->project,
+                     "bank", &job->bank,
+                     "exception_type", &job->exception_type,
+                     "exception_note", &job->exception_note,
+                     "ranks", &ranks,
+                     "nodelist", &nodelist,
+                     "annotations", &annotations,
+                     "dependencies", &dependencies) < 0) {
+        errno = EPROTO;
+        goto error;
+    }
+    job->userid = userid;
+    job->priority = priority;
+    job->success = success;
+    job->exception_occurred = exception_occurred;
+    job->result = result;
+    job->state = FLUX_JOB_STATE_INACTIVE;
+    if ((ranks && !(job->ranks = strdup (ranks)))
+        || (nodelist && !(job->nodelist = strdup (nodelist))))
+        goto error;
+    if (annotations)
+        job->annotations = json_incref (annotations);
+    if (dependencies) {
+        json_array_foreach (dependencies, index, entry) {
+            const char *s = json_string_value (entry);
+            if (s && grudgeset_add (&job->dependencies, s) < 0)
+                goto error;
+        }
+    }
+    /* string fields point into 'o' until interned by job_compact()
+     */
+    if (job_compact (job, sp) < 0)
+        goto error;
+    return job;
+error:
+    job_destroy (job);
+    return NULL;
+}
+
 /*
  * vi:tabstop=4 shiftwidth=4 expandtab
  */
@@ -19,6 +19,19 @@
 #include "src/common/libutil/grudgeset.h"
 #include "src/common/libczmqcontainers/czmq_containers.h"
 
+/* Pool of reference counted strings shared by compacted jobs.
+ */
+struct job_strpool;
+
+/* Secondary indexes of inactive jobs maintained by job_state.c
+ */
+enum job_index_type {
+    JOB_INDEX_USERID = 0,
+    JOB_INDEX_QUEUE = 1,
+    JOB_INDEX_NAME = 2,
+    JOB_INDEX_COUNT = 3,
+};
+
 /* timestamp of when we enter the state
  *
  * associated eventlog entries when restarting
@@ -81,6 +94,11 @@ struct job {
     unsigned int states_mask;
     unsigned int states_events_mask;
     void *list_handle;
+    /* handles in secondary indexes of inactive jobs, see job_state.h */
+    void *index_handle[JOB_INDEX_COUNT];
+
+    /* non-NULL if job has been compacted, see job_compact() */
+    struct job_strpool *strpool;
 
     int submit_version;         /* version number in submit context */
 };
@@ -133,6 +151,36 @@ int job_parse_R_fatal (struct job *job, const char *s, json_t *updates);
  */
 int job_R_update (struct job *job, json_t *updates);
 
+struct job_strpool *job_strpool_create (void);
+
+/* Destroy string pool.  All jobs compacted with this pool must be
+ * destroyed first.
+ */
+void job_strpool_destroy (struct job_strpool *sp);
+
+/* Reduce memory used by an inactive job. Strings that point into
+ * the jobspec or exception context (name, queue, cwd, project, bank,
+ * exception type and note) are replaced with copies interned in 'sp',
+ * then jobspec, R, exception context, and the nodelist and ranks caches
+ * are freed.  All values reported by job-list have already been parsed
+ * out of jobspec and R by this point, so none are lost.
+ *
+ * A compacted job can no longer accept jobspec or R updates.
+ */
+int job_compact (struct job *job, struct job_strpool *sp);
+
+/* Encode the values of inactive 'job' reported by job-list in a JSON
+ * object, for saving job-list state across a restart.
+ */
+json_t *job_snapshot (struct job *job);
+
+/* Create an inactive job from an object returned by job_snapshot().
+ * The job is compacted with string pool 'sp'.
+ */
+struct job *job_create_from_snapshot (flux_t *h,
+                                      json_t *o,
+                                      struct job_strpool *sp);
+
 #endif /* ! _FLUX_JOB_LIST_JOB_DATA_H */
 
 /*
@@ -23,6 +23,7 @@
 #include "src/common/libutil/fsd.h"
 #include "src/common/libutil/jpath.h"
 #include "src/common/libutil/grudgeset.h"
+#include "src/common/libutil/errno_safe.h"
 #include "src/common/libjob/job_hash.h"
 #include "src/common/libjob/idf58.h"
 #include "src/common/libidset/idset.h"
@@ -34,6 +35,10 @@
 #include "idsync.h"
 #include "job_util.h"
 
+static const char *checkpoint_key = "checkpoint.job-list";
+static const double checkpoint_timeout = 1.;
+static const int checkpoint_compact_min = 1000;
+
 #define NUMCMP(a,b) ((a)==(b)?0:((a)<(b)?-1:1))
 
 /* REVERT - flag indicates state transition is a revert, avoid certain
@@ -45,6 +50,7 @@
 #define STATE_TRANSITION_FLAG_REVERT 0x1
 #define STATE_TRANSITION_FLAG_CONDITIONAL 0x2
 
+static void checkpoint_add (struct job_state_ctx *jsctx, struct job *job);
 static int submit_context_parse (flux_t *h,
                                  struct job *job,
                                  json_t *context);
@@ -156,6 +162,91 @@ static void update_job_state (struct job_state_ctx *jsctx,
     job->states_mask |= job->state;
 }
 
+/* Return key for 'job' in index 'type', or NULL if job has no value
+ * for the indexed attribute.
+ */
+static const char *job_index_key (struct job *job,
+                                  enum job_index_type type,
+                                  char *buf,
+                                  size_t size)
+{
+    switch (type) {
+        case JOB_INDEX_USERID:
+            snprintf (buf, size, "%u", (unsigned int) job->userid);
+            return buf;
+        case JOB_INDEX_QUEUE:
+            return job->queue;
+        case JOB_INDEX_NAME:
+            return job->name;
+        default:
+            return NULL;
+    }
+}
+
+static void index_list_destructor (void **item)
+{
+    if (item) {
+        zlistx_destroy ((zlistx_t **) item);
+        *item = NULL;
+    }
+}
+
+static int job_index_add (struct job_state_ctx *jsctx, struct job *job)
+{
+    for (int type = 0; type < JOB_INDEX_COUNT; type++) {
+        char buf[32];
+        const char *key;
+        zlistx_t *l;
+
+        if (!(key = job_index_key (job, type, buf, sizeof (buf))))
+            continue;
+        if (!(l = zhashx_lookup (jsctx->inactive_index[type], key))) {
+            if (!(l = zlistx_new ()))
+                goto enomem;
+            zlistx_set_comparator (l, job_inactive_cmp);
+            if (zhashx_insert (jsctx->inactive_index[type], key, l) < 0) {
+                zlistx_destroy (&l);
+                goto enomem;
+            }
+        }
+        if (!(job->index_handle[type] = zlistx_insert (l, job, true)))
+            goto enomem;
+    }
+    return 0;
+enomem:
+    job_state_index_remove (jsctx, job);
+    errno = ENOMEM;
+    return -1;
+}
+
+void job_state_index_remove (struct job_state_ctx *jsctx, struct job *job)
+{
+    for (int type = 0; type < JOB_INDEX_COUNT; type++) {
+        char buf[32];
+        const char *key;
+        zlistx_t *l;
+
+        if (!job->index_handle[type])
+            continue;
+        if ((key = job_index_key (job, type, buf, sizeof (buf)))
+            && (l = zhashx_lookup (jsctx->inactive_index[type], key))) {
+            zlistx_detach (l, job->index_handle[type]);
+            if (zlistx_size (l) == 0)
+                zhashx_delete (jsctx->inactive_index[type], key);
+        }
+        job->index_handle[type] = NULL;
+    }
+}
+
+zlistx_t *job_state_index_lookup (struct job_state_ctx *jsctx,
+                                  enum job_index_type type,
+                                  const char *key)
+{
+    if ((int) type < 0 || type >= JOB_INDEX_COUNT || !key)
+        return NULL;
+    return zhashx_lookup (jsctx->inactive_index[type], key);
+}
+
 static int job_insert_list (struct job_state_ctx *jsctx,
                             struct job *job,
                             flux_job_state_t newstate)
@@ -176,6 +267,11 @@ static int job_insert_list (struct job_state_ctx *jsctx,
     else { /* newstate == FLUX_JOB_STATE_INACTIVE */
         if (!(job->list_handle = zlistx_insert (jsctx->inactive, job, true)))
             goto enomem;
+        if (job_index_add (jsctx, job) < 0) {
+            zlistx_detach (jsctx->inactive, job->list_handle);
+            job->list_handle = NULL;
+            goto enomem;
+        }
     }
 
     return 0;
@@ -314,6 +410,17 @@ static void process_state_transition_update (struct job_state_ctx *jsctx,
             eventlog_inactive_complete (job);
 
         update_job_state_and_list (jsctx, job, state, timestamp);
+
+        /* nothing further will be parsed from jobspec or R, so
+         * release them to reduce memory held by inactive jobs
+         */
+        if (state == FLUX_JOB_STATE_INACTIVE) {
+            if (job_compact (job, jsctx->strpool) < 0)
+                flux_log_error (jsctx->h,
+                                "%s: error compacting inactive job",
+                                idf58 (job->id));
+            checkpoint_add (jsctx, job);
+        }
     }
 }
 
@@ -324,7 +431,10 @@ static void update_jobspec (struct job_state_ctx *jsctx,
 {
     /* It is theoretically possible an update could occur before the
      * jobspec is available.  We don't handle it, just log an error.
+     * Compacted (inactive) jobs no longer hold a jobspec.
      */
+    if (job->strpool)
+        return;
     if (!job->jobspec) {
         flux_log (jsctx->h, LOG_ERR,
                   "%s: job %s received jobspec update before jobspec",
@@ -349,8 +459,10 @@ static void update_resource (struct job_state_ctx *jsctx,
                              json_t *context)
 {
     /* R should always be available at this point, outside of
-     * testing scenarios.
+     * testing scenarios.  Compacted (inactive) jobs no longer hold R.
      */
+    if (job->strpool)
+        return;
     if (!job->R) {
         flux_log (jsctx->h, LOG_ERR,
                   "%s: job %s received resource update before R",
@@ -643,8 +755,9 @@ static int exception_context_parse (flux_t *h,
         return -1;
     }
 
-    if (!job->exception_occurred
-        || severity < job->exception_severity) {
+    if (!job->strpool
+        && (!job->exception_occurred
+            || severity < job->exception_severity)) {
         job->exception_occurred = true;
         job->exception_severity = severity;
         job->exception_type = type;
@@ -858,7 +971,7 @@ static int journal_process_event (struct job_state_ctx *jsctx,
 
     job = zhashx_lookup (jsctx->index, &id);
     if (job) {
-        if (!job->R && R)
+        if (!job->R && R && !job->strpool)
             job->R = json_incref (R);
     }
 
@@ -996,8 +1109,8 @@ static int journal_process_event (struct job_state_ctx *jsctx,
     return 0;
 }
 
-static int journal_process_events (struct job_state_ctx *jsctx,
-                                   const flux_msg_t *msg)
+static int journal_process_job_events (struct job_state_ctx *jsctx,
+                                       json_t *o)
 {
     flux_jobid_t id;
     json_t *events;
@@ -1006,14 +1119,13 @@ static int journal_process_events (struct job_state_ctx *jsctx,
     json_t *jobspec = NULL;
     json_t *R = NULL;
 
-    if (flux_msg_unpack (msg,
-                        "{s:I s:o s?o s?o}",
-                        "id", &id,
-                        "events", &events,
-                        "jobspec", &jobspec,
-                        "R", &R) < 0)
-        return -1;
-    if (!json_is_array (events)) {
+    if (json_unpack (o,
+                     "{s:I s:o s?o s?o}",
+                     "id", &id,
+                     "events", &events,
+                     "jobspec", &jobspec,
+                     "R", &R) < 0
+        || !json_is_array (events)) {
         errno = EPROTO;
         return -1;
     }
@@ -1025,13 +1137,406 @@ static int journal_process_events (struct job_state_ctx *jsctx,
     return 0;
 }
 
+/* A journal response is either the events of one job or, once the
+ * backlog has been sent, a batch of such objects.
+ */
+static int journal_process_events (struct job_state_ctx *jsctx,
+                                   const flux_msg_t *msg)
+{
+    json_t *o;
+    json_t *batch = NULL;
+    size_t index;
+    json_t *value;
+
+    if (flux_msg_unpack (msg, "o", &o) < 0)
+        return -1;
+    if (json_unpack (o, "{s?o}", "batch", &batch) < 0
+        || (batch && !json_is_array (batch))) {
+        errno = EPROTO;
+        return -1;
+    }
+    if (!batch)
+        return journal_process_job_events (jsctx, o);
+    json_array_foreach (batch, index, value) {
+        if (journal_process_job_events (jsctx, value) < 0)
+            return -1;
+    }
+    return 0;
+}
+
+/* Load inactive jobs saved by the checkpoint, an RFC 18 eventlog with
+ * one "job" entry per inactive job.  They are not restored until the
+ * journal sentinel identifies which of them are still retained by the
+ * job manager.  Failure to load the checkpoint is not fatal, all jobs
+ * are then obtained from the journal and the checkpoint is rewritten.
+ */
+static void restore_start (struct job_state_ctx *jsctx)
+{
+    flux_future_t *f;
+    const char *s;
+    json_t *log = NULL;
+    json_t *jobs = NULL;
+    size_t index;
+    json_t *entry;
+
+    if (!(f = flux_kvs_lookup (jsctx->h, NULL, 0, checkpoint_key))
+        || flux_kvs_lookup_get (f, &s) < 0) {
+        if (errno != ENOENT) {
+            flux_log_error (jsctx->h, "error loading %s", checkpoint_key);
+            jsctx->checkpoint_rewrite = true;
+        }
+        goto out;
+    }
+    if (!(log = eventlog_decode (s)) || !(jobs = json_array ()))
+        goto invalid;
+    json_array_foreach (log, index, entry) {
+        const char *name;
+        json_t *context;
+        json_int_t id;
+
+        if (eventlog_entry_parse (entry, NULL, &name, &context) < 0
+            || !streq (name, "job")
+            || json_unpack (context, "{s:I}", "id", &id) < 0
+            || json_array_append (jobs, context) < 0)
+            goto invalid;
+    }
+    jsctx->snapshot = jobs;
+    jsctx->checkpoint_count = json_array_size (jobs);
+    jobs = NULL;
+    goto out;
+invalid:
+    flux_log (jsctx->h, LOG_ERR, "%s: invalid checkpoint", checkpoint_key);
+    jsctx->checkpoint_rewrite = true;
+out:
+    json_decref (jobs);
+    json_decref (log);
+    flux_future_destroy (f);
+}
+
+/* Return the ids of the checkpointed jobs, so that the job manager
+ * can omit those it still retains from the journal backlog.
+ */
+static json_t *restore_ids (struct job_state_ctx *jsctx)
+{
+    json_t *ids;
+    size_t index;
+    json_t *entry;
+
+    if (!(ids = json_array ()))
+        goto nomem;
+    if (jsctx->snapshot) {
+        json_array_foreach (jsctx->snapshot, index, entry) {
+            json_t *id = json_object_get (entry, "id");
+            if (json_array_append (ids, id) < 0)
+                goto nomem;
+        }
+    }
+    return ids;
+nomem:
+    json_decref (ids);
+    errno = ENOMEM;
+    return NULL;
+}
+
+/* Restore the checkpointed jobs whose ids are listed in 'inactive', the
+ * inactive jobs that the job manager omitted from the journal backlog.
+ * Other checkpointed jobs have been purged.  Inactive jobs that are
+ * missing from the checkpoint were sent in the backlog instead.
+ */
+static int restore_finish (struct job_state_ctx *jsctx, json_t *inactive)
+{
+    zhashx_t *retained = NULL;
+    size_t index;
+    json_t *entry;
+    int count = 0;
+    int rc = -1;
+
+    if (!jsctx->snapshot)
+        return 0;
+    if (!inactive)
+        goto done;
+    if (!json_is_array (inactive)) {
+        errno = EPROTO;
+        goto out;
+    }
+    if (!(retained = job_hash_create ()))
+        goto nomem;
+    json_array_foreach (inactive, index, entry) {
+        flux_jobid_t id = json_integer_value (entry);
+        (void)zhashx_insert (retained, &id, entry);
+    }
+    /* Entries are appended as jobs become inactive, so restoring them
+     * in order inserts each job at the head of the sorted inactive list.
+     */
+    json_array_foreach (jsctx->snapshot, index, entry) {
+        struct job *job;
+        json_int_t id;
+
+        if (json_unpack (entry, "{s:I}", "id", &id) < 0
+            || !zhashx_lookup (retained, &id))
+            continue;
+        zhashx_delete (retained, &id);
+        if (!(job = job_create_from_snapshot (jsctx->h,
+                                              entry,
+                                              jsctx->strpool))) {
+            flux_log_error (jsctx->h,
+                            "%s: error restoring job from checkpoint",
+                            idf58 (id));
+            continue;
+        }
+        if (zhashx_insert (jsctx->index, &job->id, job) < 0) {
+            job_destroy (job);
+            continue;
+        }
+        /* account for the job in stats as if it were just submitted
+         */
+        job->state = FLUX_JOB_STATE_NEW;
+        job_stats_update (jsctx->statsctx, job, FLUX_JOB_STATE_INACTIVE);
+        job->state = FLUX_JOB_STATE_INACTIVE;
+        if (job_insert_list (jsctx, job, FLUX_JOB_STATE_INACTIVE) < 0) {
+            job_stats_purge (jsctx->statsctx, job);
+            zhashx_delete (jsctx->index, &job->id);
+            goto out;
+        }
+        count++;
+    }
+    flux_log (jsctx->h,
+              LOG_DEBUG,
+              "restored %d inactive jobs from %s",
+              count,
+              checkpoint_key);
+done:
+    json_decref (jsctx->snapshot);
+    jsctx->snapshot = NULL;
+    rc = 0;
+    goto out;
+nomem:
+    errno = ENOMEM;
+out:
+    zhashx_destroy (&retained);
+    return rc;
+}
+
+/* Encode the checkpoint entry for an inactive job.
+ */
+static char *checkpoint_entry_encode (struct job *job)
+{
+    json_t *o;
+    json_t *entry = NULL;
+    char *s = NULL;
+
+    if ((o = job_snapshot (job))
+        && (entry = eventlog_entry_pack (job->t_inactive, "job", "O", o)))
+        s = eventlog_entry_encode (entry);
+    ERRNO_SAFE_WRAP (json_decref, entry);
+    ERRNO_SAFE_WRAP (json_decref, o);
+    return s;
+}
+
+/* Build a transaction that replaces the checkpoint with all inactive
+ * jobs, oldest first, dropping entries for jobs that have been purged.
+ */
+static flux_kvs_txn_t *checkpoint_rewrite_txn (struct job_state_ctx *jsctx)
+{
+    flux_kvs_txn_t *txn;
+    struct job *job;
+    char *s = NULL;
+    size_t len = 0;
+    FILE *stream;
+
+    if (!(stream = open_memstream (&s, &len)))
+        return NULL;
+    job = zlistx_last (jsctx->inactive);
+    while (job) {
+        char *line;
+
+        if (!(line = checkpoint_entry_encode (job)))
+            goto error;
+        fputs (line, stream);
+        free (line);
+        job = zlistx_prev (jsctx->inactive);
+    }
+    if (fclose (stream) != 0) {
+        stream = NULL;
+        goto error;
+    }
+    stream = NULL;
+    if (!(txn = flux_kvs_txn_create ())
+        || flux_kvs_txn_put (txn, 0, checkpoint_key, s) < 0) {
+        ERRNO_SAFE_WRAP (flux_kvs_txn_destroy, txn);
+        goto error;
+    }
+    free (s);
+    return txn;
+error:
+    if (stream)
+        ERRNO_SAFE_WRAP (fclose, stream);
+    ERRNO_SAFE_WRAP (free, s);
+    return NULL;
+}
+
+/* Build a transaction that appends jobs that became inactive since the
+ * last commit.  Rewrite the checkpoint instead once it holds more than
+ * twice as many entries as there are inactive jobs, so that entries for
+ * purged jobs do not accumulate.
+ */
+static flux_kvs_txn_t *checkpoint_txn (struct job_state_ctx *jsctx)
+{
+    flux_kvs_txn_t *txn;
+    size_t index;
+    json_t *entry;
+    int count = jsctx->checkpoint_count + json_array_size (jsctx->checkpoint);
+    int inactive = zlistx_size (jsctx->inactive);
+
+    if (jsctx->checkpoint_rewrite
+        || (count > checkpoint_compact_min && count > 2 * inactive)) {
+        if (!(txn = checkpoint_rewrite_txn (jsctx)))
+            return NULL;
+        jsctx->checkpoint_rewrite = false;
+        jsctx->checkpoint_commit_count = inactive;
+        jsctx->checkpoint_count = 0;
+        goto done;
+    }
+    if (!(txn = flux_kvs_txn_create ()))
+        return NULL;
+    json_array_foreach (jsctx->checkpoint, index, entry) {
+        if (flux_kvs_txn_put (txn,
+                              FLUX_KVS_APPEND,
+                              checkpoint_key,
+                              json_string_value (entry)) < 0) {
+            ERRNO_SAFE_WRAP (flux_kvs_txn_destroy, txn);
+            return NULL;
+        }
+    }
+    jsctx->checkpoint_commit_count = json_array_size (jsctx->checkpoint);
+done:
+    json_array_clear (jsctx->checkpoint);
+    return txn;
+}
+
+/* Arm the timer to commit queued checkpoint entries, unless a commit is
+ * already in flight, in which case its continuation arms it.
+ */
+static void checkpoint_schedule (struct job_state_ctx *jsctx)
+{
+    if (jsctx->checkpoint_f
+        || flux_watcher_is_active (jsctx->checkpoint_timer))
+        return;
+    flux_timer_watcher_reset (jsctx->checkpoint_timer, checkpoint_timeout, 0.);
+    flux_watcher_start (jsctx->checkpoint_timer);
+}
+
+static void checkpoint_continuation (flux_future_t *f, void *arg)
+{
+    struct job_state_ctx *jsctx = arg;
+
+    if (flux_future_get (f, NULL) < 0) {
+        flux_log_error (jsctx->h, "error saving %s", checkpoint_key);
+        /* the checkpoint may now be incomplete, so replace it next time
+         */
+        jsctx->checkpoint_rewrite = true;
+    }
+    else
+        jsctx->checkpoint_count += jsctx->checkpoint_commit_count;
+    flux_future_destroy (f);
+    jsctx->checkpoint_f = NULL;
+    if (json_array_size (jsctx->checkpoint) > 0)
+        checkpoint_schedule (jsctx);
+}
+
+static void checkpoint_commit (struct job_state_ctx *jsctx)
+{
+    flux_kvs_txn_t *txn;
+    flux_future_t *f = NULL;
+
+    if (!(txn = checkpoint_txn (jsctx))
+        || !(f = flux_kvs_commit (jsctx->h, NULL, 0, txn))
+        || flux_future_then (f, -1., checkpoint_continuation, jsctx) < 0) {
+        flux_log_error (jsctx->h, "error saving %s", checkpoint_key);
+        jsctx->checkpoint_rewrite = true;
+        flux_future_destroy (f);
+        f = NULL;
+    }
+    jsctx->checkpoint_f = f;
+    flux_kvs_txn_destroy (txn);
+}
+
+static void checkpoint_timer_cb (flux_reactor_t *r,
+                                 flux_watcher_t *w,
+                                 int revents,
+                                 void *arg)
+{
+    struct job_state_ctx *jsctx = arg;
+
+    /* Only one commit is in flight at a time, so that appends land in
+     * order.  The continuation rearms the timer if jobs were added.
+     */
+    checkpoint_commit (jsctx);
+}
+
+/* Queue a newly inactive job to be appended to the checkpoint.  Jobs
+ * are accumulated for checkpoint_timeout seconds so that a burst of
+ * completions costs one KVS commit.
+ */
+static void checkpoint_add (struct job_state_ctx *jsctx, struct job *job)
+{
+    char *s;
+
+    if (!(s = checkpoint_entry_encode (job))
+        || json_array_append_new (jsctx->checkpoint, json_string (s)) < 0) {
+        flux_log_error (jsctx->h,
+                        "%s: error adding job to %s",
+                        idf58 (job->id),
+                        checkpoint_key);
+        jsctx->checkpoint_rewrite = true;
+    }
+    checkpoint_schedule (jsctx);
+    free (s);
+}
+
+int job_state_checkpoint (struct job_state_ctx *jsctx)
+{
+    flux_kvs_txn_t *txn = NULL;
+    flux_future_t *f = NULL;
+    int count = zlistx_size (jsctx->inactive);
+    int rc = -1;
+
+    /* Do not replace a good checkpoint with a partial job list
+     */
+    if (!jsctx->initialized)
+        return 0;
+    /* Let an in-flight append land before it is replaced.
+     */
+    if (jsctx->checkpoint_f) {
+        (void)flux_future_get (jsctx->checkpoint_f, NULL);
+        flux_future_destroy (jsctx->checkpoint_f);
+        jsctx->checkpoint_f = NULL;
+    }
+    flux_watcher_stop (jsctx->checkpoint_timer);
+    json_array_clear (jsctx->checkpoint);
+    if (!(txn = checkpoint_rewrite_txn (jsctx))
+        || !(f = flux_kvs_commit (jsctx->h, NULL, 0, txn))
+        || flux_future_get (f, NULL) < 0)
+        goto error;
+    flux_log (jsctx->h,
+              LOG_DEBUG,
+              "saved %d inactive jobs to %s",
+              count,
+              checkpoint_key);
+    rc = 0;
+error:
+    flux_future_destroy (f);
+    flux_kvs_txn_destroy (txn);
+    return rc;
+}
+
 static void job_events_journal_continuation (flux_future_t *f, void *arg)
 {
     struct job_state_ctx *jsctx = arg;
     const flux_msg_t *msg;
-    flux_jobid_t id;
+    flux_jobid_t id = 0;
 
-    if (flux_rpc_get_unpack (f, "{s:I}", "id", &id) < 0
+    if (flux_rpc_get_unpack (f, "{s?I}", "id", &id) < 0
         || flux_future_get (f, (const void **)&msg) < 0) {
         if (errno == ENODATA) {
             flux_log (jsctx->h, LOG_INFO, "journal: EOF (exiting)");
@@ -1047,6 +1552,12 @@ static void job_events_journal_continuation (flux_future_t *f, void *arg)
      * as they arrive.
      */
     if (id == FLUX_JOBID_ANY) {
+        json_t *inactive = NULL;
+        if (flux_msg_unpack (msg, "{s?o}", "inactive", &inactive) < 0
+            || restore_finish (jsctx, inactive) < 0) {
+            flux_log_error (jsctx->h, "error restoring jobs from checkpoint");
+            goto error;
+        }
         while ((msg = flux_msglist_pop (jsctx->backlog))) {
             int rc = journal_process_events (jsctx, msg);
             flux_msg_decref (msg);
@@ -1084,17 +1595,26 @@ error:
 
 static flux_future_t *job_events_journal (struct job_state_ctx *jsctx)
 {
-    flux_future_t *f;
+    flux_future_t *f = NULL;
+    json_t *ids;
 
+    if (!(ids = restore_ids (jsctx))) {
+        flux_log_error (jsctx->h, "error preparing journal request");
+        return NULL;
+    }
     /* Set full=true so that inactive jobs are included.
      * Don't set allow/deny so that we receive all events.
+     * Set inactive_known to skip jobs restored from checkpoint.
+     * Set batch=true to receive new events in batches.
      */
     if (!(f = flux_rpc_pack (jsctx->h,
                              "job-manager.events-journal",
                              FLUX_NODEID_ANY,
                              FLUX_RPC_STREAMING,
-                             "{s:b}",
-                             "full", 1))
+                             "{s:b s:o s:b}",
+                             "full", 1,
+                             "inactive_known", ids,
+                             "batch", 1))
         || flux_future_then (f,
                              -1,
                              job_events_journal_continuation,
@@ -1146,12 +1666,34 @@ struct job_state_ctx *job_state_create (struct list_ctx *ctx)
     if (!(jsctx->processing = zlistx_new ()))
         goto error;
 
+    if (!(jsctx->strpool = job_strpool_create ()))
+        goto error;
+
+    for (int type = 0; type < JOB_INDEX_COUNT; type++) {
+        if (!(jsctx->inactive_index[type] = zhashx_new ()))
+            goto error;
+        zhashx_set_destructor (jsctx->inactive_index[type],
+                               index_list_destructor);
+    }
+
     if (!(jsctx->statsctx = job_stats_ctx_create (jsctx->h)))
         goto error;
 
     if (!(jsctx->backlog = flux_msglist_create ()))
         goto error;
 
+    if (!(jsctx->checkpoint = json_array ()))
+        goto error;
+    if (!(jsctx->checkpoint_timer =
+              flux_timer_watcher_create (flux_get_reactor (jsctx->h),
+                                         0.,
+                                         0.,
+                                         checkpoint_timer_cb,
+                                         jsctx)))
+        goto error;
+
+    restore_start (jsctx);
+
     if (!(jsctx->events = job_events_journal (jsctx)))
         goto error;
 
@@ -1169,14 +1711,21 @@ void job_state_destroy (void *data)
         int saved_errno = errno;
         /* Destroy index last, as it is the one that will actually
          * destroy the job objects */
+        for (int type = 0; type < JOB_INDEX_COUNT; type++)
+            zhashx_destroy (&jsctx->inactive_index[type]);
         zlistx_destroy (&jsctx->processing);
         zlistx_destroy (&jsctx->inactive);
         zlistx_destroy (&jsctx->running);
         zlistx_destroy (&jsctx->pending);
         zhashx_destroy (&jsctx->index);
+        job_strpool_destroy (jsctx->strpool);
         job_stats_ctx_destroy (jsctx->statsctx);
         flux_msglist_destroy (jsctx->backlog);
         flux_future_destroy (jsctx->events);
+        json_decref (jsctx->snapshot);
+        flux_future_destroy (jsctx->checkpoint_f);
+        flux_watcher_destroy (jsctx->checkpoint_timer);
+        json_decref (jsctx->checkpoint);
         free (jsctx);
         errno = saved_errno;
     }
@@ -34,6 +34,12 @@
  *
  * There is also an additional list `processing` that stores jobs that
  * cannot yet be stored on one of the lists above.
+ *
+ * Inactive jobs are additionally indexed by userid, queue, and name
+ * so that list requests constrained on one of those need not scan the
+ * entire inactive list.  Each index is a hash of key -> list of jobs
+ * sorted like the inactive list. Since these job attributes cannot
+ * change once a job is inactive, only the inactive list is indexed.
  */
 
 struct job_state_ctx {
@@ -45,6 +51,10 @@ struct job_state_ctx {
     zlistx_t *running;
     zlistx_t *inactive;
     zlistx_t *processing;
+    zhashx_t *inactive_index[JOB_INDEX_COUNT];
+
+    /* strings shared by compacted inactive jobs */
+    struct job_strpool *strpool;
 
     /*  Job statistics: */
     struct job_stats_ctx *statsctx;
@@ -56,6 +66,21 @@ struct job_state_ctx {
     /* stream of job events from the job-manager */
     flux_future_t *events;
 
+    /* inactive jobs loaded from checkpoint, pending confirmation by
+     * the job-manager journal sentinel
+     */
+    json_t *snapshot;
+
+    /* checkpoint entries for newly inactive jobs, appended to the KVS
+     * in batches.  checkpoint_count is the number of entries in the KVS.
+     */
+    json_t *checkpoint;
+    flux_watcher_t *checkpoint_timer;
+    flux_future_t *checkpoint_f;
+    int checkpoint_count;
+    int checkpoint_commit_count;
+    bool checkpoint_rewrite;
+
     bool initialized;
 };
 
@@ -63,12 +88,30 @@ struct job_state_ctx *job_state_create (struct list_ctx *ctx);
 
 void job_state_destroy (void *data);
 
+/* Replace the KVS checkpoint of inactive jobs, which is otherwise
+ * appended to as jobs become inactive, with the current inactive list
+ * so that a restarted job-list need not rebuild them from the journal.
+ */
+int job_state_checkpoint (struct job_state_ctx *jsctx);
+
 void job_state_pause_cb (flux_t *h, flux_msg_handler_t *mh,
                          const flux_msg_t *msg, void *arg);
 
 void job_state_unpause_cb (flux_t *h, flux_msg_handler_t *mh,
                            const flux_msg_t *msg, void *arg);
 
+/* Return list of inactive jobs with key 'key' in index 'type', sorted
+ * in the same order as the inactive list, or NULL if there are none.
+ * For JOB_INDEX_USERID, key is the userid in decimal.
+ */
+zlistx_t *job_state_index_lookup (struct job_state_ctx *jsctx,
+                                  enum job_index_type type,
+                                  const char *key);
+
+/* Remove an inactive job from the secondary indexes, e.g. on purge.
+ */
+void job_state_index_remove (struct job_state_ctx *jsctx, struct job *job);
+
 int job_state_config_reload (struct job_state_ctx *jsctx,
                              const flux_conf_t *conf,
                              flux_error_t *errp);
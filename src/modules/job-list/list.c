@@ -30,6 +30,9 @@
 #include "match.h"
 #include "state_match.h"
 
+/* Default number of jobs per response for streaming list requests */
+#define LIST_STREAM_CHUNK_SIZE 1000
+
 json_t *get_job_by_id (struct job_state_ctx *jsctx,
                        flux_error_t *errp,
                        const flux_msg_t *msg,
@@ -38,19 +41,22 @@ json_t *get_job_by_id (struct job_state_ctx *jsctx,
                        flux_job_state_t state,
                        bool *stall);
 
-/* Put jobs from list onto jobs array, breaking if max_entries has
- * been reached. Returns 1 if jobs array is full, 0 if continue, -1
- * one error with errno set:
- *
- * ENOMEM - out of memory
+/* Callback for each job matched by foreach_job().  Return 1 to stop
+ * iteration, 0 to continue, or -1 on error with errno set.
  */
-int get_jobs_from_list (json_t *jobs,
-                        flux_error_t *errp,
-                        zlistx_t *list,
-                        int max_entries,
-                        json_t *attrs,
-                        double since,
-                        struct list_constraint *c)
+typedef int (*job_iter_f) (struct job *job, void *arg, flux_error_t *errp);
+
+/* Call 'cb' for each job on list that matches constraint 'c', stopping
+ * if the callback returns non-zero.  Returns 1 if iteration was stopped
+ * by the callback, 0 if the list was exhausted, -1 on error with errno
+ * set.
+ */
+static int foreach_job_in_list (zlistx_t *list,
+                                double since,
+                                struct list_constraint *c,
+                                job_iter_f cb,
+                                void *arg,
+                                flux_error_t *errp)
 {
     struct job *job;
 
@@ -72,23 +78,119 @@ int get_jobs_from_list (json_t *jobs,
         if ((ret = job_match (job, c, errp)) < 0)
             return -1;
         if (ret) {
-            json_t *o;
-            if (!(o = job_to_json (job, attrs, errp)))
+            if ((ret = cb (job, arg, errp)) != 0)
+                return ret;
+        }
+        job = zlistx_next (list);
+    }
+
+    return 0;
+}
+
+/* Select the list of inactive jobs to scan for constraint 'c'.  If 'c'
+ * pins the userid, queue, or name of matching jobs, the smallest
+ * corresponding secondary index list is returned, since every matching
+ * job must be on it.  Jobs on that list are still run through
+ * job_match() to apply the rest of the constraint.  Returns NULL if no
+ * inactive job can match.
+ */
+static zlistx_t *inactive_list_select (struct job_state_ctx *jsctx,
+                                       struct list_constraint *c)
+{
+    zlistx_t *list = jsctx->inactive;
+
+    for (int type = 0; type < JOB_INDEX_COUNT; type++) {
+        char buf[32];
+        const char *key;
+        zlistx_t *l;
+
+        if (!(key = list_constraint_index_key (c, type, buf, sizeof (buf))))
+            continue;
+        if (!(l = job_state_index_lookup (jsctx, type, key)))
+            return NULL;
+        if (zlistx_size (l) < zlistx_size (list))
+            list = l;
+    }
+    return list;
+}
+
+/* Call 'cb' for each job matching 'c' and 'statec', in the order jobs
+ * are returned by job-list.list: pending, running, then inactive.
+ * Returns 0 on success, -1 on error with errno set.
+ */
+static int foreach_job (struct job_state_ctx *jsctx,
+                        double since,
+                        struct list_constraint *c,
+                        struct state_constraint *statec,
+                        job_iter_f cb,
+                        void *arg,
+                        flux_error_t *errp)
+{
+    int ret = 0;
+
+    if (state_match (FLUX_JOB_STATE_PENDING, statec)) {
+        if ((ret = foreach_job_in_list (jsctx->pending,
+                                        0.,
+                                        c,
+                                        cb,
+                                        arg,
+                                        errp)) < 0)
+            return -1;
+    }
+
+    if (state_match (FLUX_JOB_STATE_RUNNING, statec)) {
+        if (!ret) {
+            if ((ret = foreach_job_in_list (jsctx->running,
+                                            0.,
+                                            c,
+                                            cb,
+                                            arg,
+                                            errp)) < 0)
                 return -1;
-            if (json_array_append_new (jobs, o) < 0) {
-                json_decref (o);
-                errno = ENOMEM;
+        }
+    }
+
+    if (state_match (FLUX_JOB_STATE_INACTIVE, statec)) {
+        zlistx_t *inactive;
+        if (!ret && (inactive = inactive_list_select (jsctx, c))) {
+            if (foreach_job_in_list (inactive,
+                                     since,
+                                     c,
+                                     cb,
+                                     arg,
+                                     errp) < 0)
                 return -1;
-            }
-            if (json_array_size (jobs) == max_entries)
-                return 1;
         }
-        job = zlistx_next (list);
     }
 
     return 0;
 }
 
+struct jobs_array {
+    json_t *jobs;
+    json_t *attrs;
+    int max_entries;
+};
+
+/* Put job onto jobs array, stopping if max_entries has been reached.
+ */
+static int jobs_array_append (struct job *job, void *arg, flux_error_t *errp)
+{
+    struct jobs_array *ja = arg;
+    json_t *o;
+
+    if (!(o = job_to_json (job, ja->attrs, errp)))
+        return -1;
+    if (json_array_append_new (ja->jobs, o) < 0) {
+        json_decref (o);
+        errno = ENOMEM;
+        return -1;
+    }
+    if (json_array_size (ja->jobs) == ja->max_entries)
+        return 1;
+    return 0;
+}
+
 /* Create a JSON array of 'job' objects.  'max_entries' determines the
  * max number of jobs to return, 0=unlimited. 'since' limits jobs returned
  * to those with t_inactive greater than timestamp.  Returns JSON object
@@ -105,61 +207,297 @@ json_t *get_jobs (struct job_state_ctx *jsctx,
                   struct list_constraint *c,
                   struct state_constraint *statec)
 {
-    json_t *jobs = NULL;
-    int saved_errno;
-    int ret = 0;
+    struct jobs_array ja = { .attrs = attrs, .max_entries = max_entries };
 
-    if (!(jobs = json_array ()))
-        goto error_nomem;
+    if (!(ja.jobs = json_array ())) {
+        errno = ENOMEM;
+        return NULL;
+    }
+    if (foreach_job (jsctx, since, c, statec, jobs_array_append, &ja, errp) < 0)
+        goto error;
+    return ja.jobs;
+error:
+    ERRNO_SAFE_WRAP (json_decref, ja.jobs);
+    return NULL;
+}
 
-    /* We return jobs in the following order, pending, running,
-     * inactive */
+/* Streaming job-list.list requests.  The ids of all matching jobs are
+ * gathered when the request is received, then job objects are built and
+ * sent 'chunk_size' at a time from a check watcher, so that a large
+ * listing neither blocks the reactor nor requires one huge response
+ * message.  Since jobs are looked up by id at send time, each job that
+ * matched the request is sent at most once, in its current state, even
+ * if it has moved between the pending, running, and inactive lists.
+ * Jobs purged since the request was received are skipped.  The stream
+ * is terminated with an ENODATA error response.
+ */
+struct list_stream {
+    const flux_msg_t *msg;
+    json_t *attrs;
+    flux_jobid_t *ids;
+    size_t count;
+    size_t size;
+    size_t pos;
+    int max_entries;
+    int chunk_size;
+};
+
+struct list_stream_ctx {
+    flux_t *h;
+    struct job_state_ctx *jsctx;
+    zlistx_t *streams;
+    flux_watcher_t *prep;
+    flux_watcher_t *check;
+    flux_watcher_t *idle;
+};
+
+static void list_stream_destroy (struct list_stream *ls)
+{
+    if (ls) {
+        int saved_errno = errno;
+        flux_msg_decref (ls->msg);
+        json_decref (ls->attrs);
+        free (ls->ids);
+        free (ls);
+        errno = saved_errno;
+    }
+}
 
-    if (state_match (FLUX_JOB_STATE_PENDING, statec)) {
-        if ((ret = get_jobs_from_list (jobs,
-                                       errp,
-                                       jsctx->pending,
-                                       max_entries,
-                                       attrs,
-                                       0.,
-                                       c)) < 0)
-            goto error;
+static void list_stream_destructor (void **item)
+{
+    if (item) {
+        list_stream_destroy (*item);
+        *item = NULL;
     }
+}
 
-    if (state_match (FLUX_JOB_STATE_RUNNING, statec)) {
-        if (!ret) {
-            if ((ret = get_jobs_from_list (jobs,
-                                           errp,
-                                           jsctx->running,
-                                           max_entries,
-                                           attrs,
-                                           0.,
-                                           c)) < 0)
-                goto error;
+static int list_stream_append_id (struct job *job,
+                                  void *arg,
+                                  flux_error_t *errp)
+{
+    struct list_stream *ls = arg;
+
+    if (ls->count == ls->size) {
+        size_t size = ls->size ? ls->size * 2 : 1024;
+        flux_jobid_t *ids;
+        if (!(ids = realloc (ls->ids, size * sizeof (ids[0])))) {
+            errno = ENOMEM;
+            return -1;
         }
+        ls->ids = ids;
+        ls->size = size;
     }
+    ls->ids[ls->count++] = job->id;
+    if (ls->count == (size_t)ls->max_entries)
+        return 1;
+    return 0;
+}
 
-    if (state_match (FLUX_JOB_STATE_INACTIVE, statec)) {
-        if (!ret) {
-            if ((ret = get_jobs_from_list (jobs,
-                                           errp,
-                                           jsctx->inactive,
-                                           max_entries,
-                                           attrs,
-                                           since,
-                                           c)) < 0)
-                goto error;
+/* Send the next chunk of jobs on stream 'ls'.  Returns 1 if the stream
+ * is complete (or failed), 0 if more jobs remain to be sent.
+ */
+static int list_stream_respond (struct list_stream_ctx *lsctx,
+                                struct list_stream *ls)
+{
+    json_t *jobs;
+    flux_error_t error = {{0}};
+
+    if (!(jobs = json_array ())) {
+        errno = ENOMEM;
+        goto error;
+    }
+    while (ls->pos < ls->count
+           && json_array_size (jobs) < (size_t)ls->chunk_size) {
+        struct job *job;
+        json_t *o;
+
+        if (!(job = zhashx_lookup (lsctx->jsctx->index, &ls->ids[ls->pos++])))
+            continue;
+        if (!(o = job_to_json (job, ls->attrs, &error))) {
+            json_decref (jobs);
+            goto error;
+        }
+        if (json_array_append_new (jobs, o) < 0) {
+            json_decref (o);
+            json_decref (jobs);
+            errno = ENOMEM;
+            goto error;
         }
     }
+    if (json_array_size (jobs) > 0) {
+        if (flux_respond_pack (lsctx->h, ls->msg, "{s:O}", "jobs", jobs) < 0) {
+            flux_log_error (lsctx->h, "%s: flux_respond_pack", __FUNCTION__);
+            json_decref (jobs);
+            return 1;
+        }
+    }
+    json_decref (jobs);
+    if (ls->pos < ls->count)
+        return 0;
+    errno = ENODATA;
+error:
+    if (flux_respond_error (lsctx->h,
+                            ls->msg,
+                            errno,
+                            error.text[0] ? error.text : NULL) < 0)
+        flux_log_error (lsctx->h, "%s: flux_respond_error", __FUNCTION__);
+    return 1;
+}
+
+static void list_stream_prep_cb (flux_reactor_t *r,
+                                 flux_watcher_t *w,
+                                 int revents,
+                                 void *arg)
+{
+    struct list_stream_ctx *lsctx = arg;
+
+    if (zlistx_size (lsctx->streams) > 0)
+        flux_watcher_start (lsctx->idle);
+}
+
+/* Send one chunk on each active stream per reactor loop iteration,
+ * so concurrent listings share the module fairly.
+ */
+static void list_stream_check_cb (flux_reactor_t *r,
+                                  flux_watcher_t *w,
+                                  int revents,
+                                  void *arg)
+{
+    struct list_stream_ctx *lsctx = arg;
+    struct list_stream *ls;
+
+    flux_watcher_stop (lsctx->idle);
+
+    ls = zlistx_first (lsctx->streams);
+    while (ls) {
+        if (list_stream_respond (lsctx, ls) == 1)
+            zlistx_delete (lsctx->streams, zlistx_cursor (lsctx->streams));
+        ls = zlistx_next (lsctx->streams);
+    }
+}
 
-    return jobs;
+static int list_stream_start (struct list_stream_ctx *lsctx,
+                              const flux_msg_t *msg,
+                              int max_entries,
+                              int chunk_size,
+                              double since,
+                              json_t *attrs,
+                              struct list_constraint *c,
+                              struct state_constraint *statec,
+                              flux_error_t *errp)
+{
+    struct list_stream *ls;
 
-error_nomem:
+    if (!(ls = calloc (1, sizeof (*ls)))) {
+        errno = ENOMEM;
+        return -1;
+    }
+    ls->msg = flux_msg_incref (msg);
+    ls->attrs = json_incref (attrs);
+    ls->max_entries = max_entries;
+    ls->chunk_size = chunk_size;
+    if (foreach_job (lsctx->jsctx,
+                     since,
+                     c,
+                     statec,
+                     list_stream_append_id,
+                     ls,
+                     errp) < 0)
+        goto error;
+    if (!zlistx_add_end (lsctx->streams, ls)) {
+        errno = ENOMEM;
+        goto error;
+    }
+    return 0;
+error:
+    list_stream_destroy (ls);
+    return -1;
+}
+
+static bool list_stream_match (struct list_stream_ctx *lsctx,
+                               const flux_msg_t *msg,
+                               bool (*match) (const flux_msg_t *msg1,
+                                              const flux_msg_t *msg2),
+                               bool respond)
+{
+    struct list_stream *ls;
+    bool found = false;
+
+    ls = zlistx_first (lsctx->streams);
+    while (ls) {
+        if (match (msg, ls->msg)) {
+            if (respond) {
+                if (flux_respond_error (lsctx->h, ls->msg, ENODATA, NULL) < 0)
+                    flux_log_error (lsctx->h,
+                                    "%s: flux_respond_error",
+                                    __FUNCTION__);
+            }
+            zlistx_delete (lsctx->streams, zlistx_cursor (lsctx->streams));
+            found = true;
+        }
+        ls = zlistx_next (lsctx->streams);
+    }
+    return found;
+}
+
+void list_stream_disconnect (struct list_stream_ctx *lsctx,
+                             const flux_msg_t *msg)
+{
+    list_stream_match (lsctx, msg, flux_disconnect_match, false);
+}
+
+void list_cancel_cb (flux_t *h,
+                     flux_msg_handler_t *mh,
+                     const flux_msg_t *msg,
+                     void *arg)
+{
+    struct list_ctx *ctx = arg;
+
+    if (flux_request_decode (msg, NULL, NULL) < 0) {
+        flux_log_error (h, "error decoding job-list.list-cancel request");
+        return;
+    }
+    list_stream_match (ctx->lsctx, msg, flux_cancel_match, true);
+}
+
+void list_stream_ctx_destroy (struct list_stream_ctx *lsctx)
+{
+    if (lsctx) {
+        int saved_errno = errno;
+        flux_watcher_destroy (lsctx->prep);
+        flux_watcher_destroy (lsctx->check);
+        flux_watcher_destroy (lsctx->idle);
+        zlistx_destroy (&lsctx->streams);
+        free (lsctx);
+        errno = saved_errno;
+    }
+}
+
+struct list_stream_ctx *list_stream_ctx_create (flux_t *h,
+                                                struct job_state_ctx *jsctx)
+{
+    struct list_stream_ctx *lsctx;
+    flux_reactor_t *r = flux_get_reactor (h);
+
+    if (!(lsctx = calloc (1, sizeof (*lsctx))))
+        return NULL;
+    lsctx->h = h;
+    lsctx->jsctx = jsctx;
+    if (!(lsctx->streams = zlistx_new ()))
+        goto nomem;
+    zlistx_set_destructor (lsctx->streams, list_stream_destructor);
+    lsctx->prep = flux_prepare_watcher_create (r, list_stream_prep_cb, lsctx);
+    lsctx->check = flux_check_watcher_create (r, list_stream_check_cb, lsctx);
+    lsctx->idle = flux_idle_watcher_create (r, NULL, NULL);
+    if (!lsctx->prep || !lsctx->check || !lsctx->idle)
+        goto error;
+    flux_watcher_start (lsctx->prep);
+    flux_watcher_start (lsctx->check);
+    return lsctx;
+nomem:
     errno = ENOMEM;
 error:
-    saved_errno = errno;
-    json_decref (jobs);
-    errno = saved_errno;
+    list_stream_ctx_destroy (lsctx);
     return NULL;
 }
 
@@ -262,6 +600,7 @@ void list_cb (flux_t *h,
     json_t *jobs;
     json_t *attrs;
     int max_entries;
+    int chunk_size = LIST_STREAM_CHUNK_SIZE;
     double since = 0.;
     json_t *constraint = NULL;
     json_t *legacy_constraint = NULL;
@@ -276,11 +615,12 @@ void list_cb (flux_t *h,
     }
     if (flux_request_unpack (msg,
                              NULL,
-                             "{s:i s:o s?F s?o}",
+                             "{s:i s:o s?F s?o s?i}",
                              "max_entries", &max_entries,
                              "attrs", &attrs,
                              "since", &since,
-                             "constraint", &constraint) < 0) {
+                             "constraint", &constraint,
+                             "chunk_size", &chunk_size) < 0) {
         errprintf (&err, "invalid payload: %s", flux_msg_last_error (msg));
         errno = EPROTO;
         goto error;
@@ -315,6 +655,11 @@ void list_cb (flux_t *h,
         errno = EPROTO;
         goto error;
     }
+    if (chunk_size <= 0) {
+        errprintf (&err, "invalid payload: chunk_size <= 0 not allowed");
+        errno = EPROTO;
+        goto error;
+    }
     if (!json_is_array (attrs)) {
         errprintf (&err, "invalid payload: attrs must be an array");
         errno = EPROTO;
@@ -335,6 +680,20 @@ void list_cb (flux_t *h,
         goto error;
     }
 
+    if (flux_msg_is_streaming (msg)) {
+        if (list_stream_start (ctx->lsctx,
+                               msg,
+                               max_entries,
+                               chunk_size,
+                               since,
+                               attrs,
+                               c,
+                               statec,
+                               &err) < 0)
+            goto error;
+        goto out;
+    }
+
     if (!(jobs = get_jobs (ctx->jsctx, &err, max_entries, since,
                            attrs, c, statec)))
         goto error;
@@ -343,6 +702,7 @@ void list_cb (flux_t *h,
         flux_log_error (h, "%s: flux_respond_pack", __FUNCTION__);
 
     json_decref (jobs);
+out:
     list_constraint_destroy (c);
     state_constraint_destroy (statec);
     json_decref (legacy_constraint);
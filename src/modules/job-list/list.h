@@ -13,9 +13,23 @@
 
 #include <flux/core.h>
 
+#include "job_state.h"
+
+struct list_stream_ctx *list_stream_ctx_create (flux_t *h,
+                                                struct job_state_ctx *jsctx);
+
+void list_stream_ctx_destroy (struct list_stream_ctx *lsctx);
+
+/* Drop streaming list requests from the sender of disconnect 'msg' */
+void list_stream_disconnect (struct list_stream_ctx *lsctx,
+                             const flux_msg_t *msg);
+
 void list_cb (flux_t *h, flux_msg_handler_t *mh,
               const flux_msg_t *msg, void *arg);
 
+void list_cancel_cb (flux_t *h, flux_msg_handler_t *mh,
+                     const flux_msg_t *msg, void *arg);
+
 void list_id_cb (flux_t *h, flux_msg_handler_t *mh,
                  const flux_msg_t *msg, void *arg);
 
@@ -33,9 +33,22 @@ struct list_constraint {
     struct match_ctx *mctx;
     zlistx_t *values;
     match_f match;
+    unsigned int cost;          /* relative cost of match, see below */
     unsigned int comparisons;   /* total across multiple calls to job_match() */
 };
 
+/* Relative cost of evaluating constraints, used to order the terms of
+ * "and", "or", and "not" so that cheap tests short-circuit expensive
+ * ones.  Bitmask and timestamp tests are a single comparison.  Others
+ * cost roughly one comparison per value, with string and hostlist
+ * comparisons weighted more heavily.
+ */
+#define COST_SIMPLE     1
+#define COST_STRING     2
+#define COST_HOST       4
+#define COST_RANKS      8
+#define COST_MAX        (1U<<20)
+
 typedef enum {
     MATCH_T_SUBMIT = 1,
     MATCH_T_DEPEND = 2,
@@ -147,6 +160,15 @@ static struct timestamp_value *timestamp_value_create_str (
     return timestamp_value_create (t, type, comp);
 }
 
+static unsigned int constraint_cost (unsigned int cost, size_t count)
+{
+    if (count == 0)
+        return COST_SIMPLE;
+    if (count > COST_MAX / cost)
+        return COST_MAX;
+    return cost * count;
+}
+
 static int match_true (struct list_constraint *c,
                        const struct job *job,
                        unsigned int *comparisons,
@@ -171,6 +193,7 @@ static struct list_constraint *list_constraint_new (struct match_ctx *mctx,
     }
     c->mctx = mctx;
     c->match = match_cb;
+    c->cost = COST_SIMPLE;
     if (destructor_cb)
         zlistx_set_destructor (c->values, destructor_cb);
     return c;
@@ -235,6 +258,7 @@ static struct list_constraint *create_userid_constraint (struct match_ctx *mctx,
             goto error;
         }
     }
+    c->cost = constraint_cost (COST_SIMPLE, zlistx_size (c->values));
     return c;
  error:
     list_constraint_destroy (c);
@@ -266,6 +290,7 @@ static struct list_constraint *create_string_constraint (struct match_ctx *mctx,
             goto error;
         }
     }
+    c->cost = constraint_cost (COST_STRING, zlistx_size (c->values));
     return c;
  error:
     list_constraint_destroy (c);
@@ -436,6 +461,7 @@ static int match_hostlist (struct list_constraint *c,
                            flux_error_t *errp)
 {
     struct hostlist *hl = zlistx_first (c->values);
+    struct hostlist *search;
     const char *host;
 
     /* nodelist may not exist if job never ran */
@@ -447,11 +473,20 @@ static int match_hostlist (struct list_constraint *c,
         if (!(jobtmp->nodelist_hl = hostlist_decode (job->nodelist)))
             return 0;
     }
+    /* Iterate over the smaller hostlist, looking up each host in
+     * the larger one.
+     */
+    if (hostlist_count (job->nodelist_hl) < hostlist_count (hl)) {
+        search = hl;
+        hl = job->nodelist_hl;
+    }
+    else
+        search = job->nodelist_hl;
     host = hostlist_first (hl);
     while (host) {
         if (inc_check_comparison (c->mctx, comparisons, errp) < 0)
             return -1;
-        if (hostlist_find (job->nodelist_hl, host) >= 0)
+        if (hostlist_find (search, host) >= 0)
             return 1;
         host = hostlist_next (hl);
     }
@@ -507,6 +542,7 @@ static struct list_constraint *create_hostlist_constraint (
         errprintf (errp, "failed to append hostlist structure");
         goto error;
     }
+    c->cost = constraint_cost (COST_HOST, hostlist_count (hl));
     return c;
  error:
     hostlist_destroy (hl);
@@ -595,6 +631,7 @@ static struct list_constraint *create_ranks_constraint (
         errprintf (errp, "failed to append idset structure");
         goto error;
     }
+    c->cost = COST_RANKS;
     return c;
  error:
     idset_destroy (idset);
@@ -754,6 +791,80 @@ static int match_not (struct list_constraint *c,
     return ret ? 0 : 1;
 }
 
+/* Return true if the terms of 'cp', a term of conditional 'c', can be
+ * merged into 'c'.  Nested "and" terms of "and" or "not" can be merged,
+ * as can nested "or" terms of "or", unless empty since an empty "or"
+ * is true.
+ */
+static bool conditional_can_merge (struct list_constraint *c,
+                                   struct list_constraint *cp)
+{
+    if (cp->match == match_and)
+        return c->match == match_and || c->match == match_not;
+    if (cp->match == match_or)
+        return c->match == match_or && zlistx_size (cp->values) > 0;
+    return false;
+}
+
+static int cost_cmp (const void *item1, const void *item2)
+{
+    const struct list_constraint *c1 = item1;
+    const struct list_constraint *c2 = item2;
+
+    if (c1->cost == c2->cost)
+        return 0;
+    return c1->cost < c2->cost ? -1 : 1;
+}
+
+/* Prepare conditional 'c' for evaluation, once all its terms have been
+ * created.  Terms of nested conditionals are merged where possible, to
+ * reduce the depth of the tree walked for each job, then terms are sorted
+ * by increasing cost.  All terms are side effect free, so their order
+ * does not change the result.
+ */
+static int conditional_optimize (struct list_constraint *c)
+{
+    zlistx_t *values;
+    struct list_constraint *cp;
+    unsigned int cost = 0;
+
+    if (!(values = zlistx_new ()))
+        return -1;
+    zlistx_set_destructor (values, list_constraint_destructor);
+    zlistx_set_comparator (values, cost_cmp);
+    while ((cp = zlistx_detach (c->values, NULL))) {
+        if (conditional_can_merge (c, cp)) {
+            struct list_constraint *gp;
+            while ((gp = zlistx_detach (cp->values, NULL))) {
+                if (!zlistx_add_end (values, gp)) {
+                    list_constraint_destroy (gp);
+                    list_constraint_destroy (cp);
+                    goto nomem;
+                }
+            }
+            list_constraint_destroy (cp);
+        }
+        else if (!zlistx_add_end (values, cp)) {
+            list_constraint_destroy (cp);
+            goto nomem;
+        }
+    }
+    zlistx_sort (values);
+    cp = zlistx_first (values);
+    while (cp) {
+        cost = cost + cp->cost < COST_MAX ? cost + cp->cost : COST_MAX;
+        cp = zlistx_next (values);
+    }
+    zlistx_destroy (&c->values);
+    c->values = values;
+    c->cost = cost > 0 ? cost : COST_SIMPLE;
+    return 0;
+nomem:
+    zlistx_destroy (&values);
+    errno = ENOMEM;
+    return -1;
+}
+
 static struct list_constraint *conditional_constraint (struct match_ctx *mctx,
                                                        const char *type,
                                                        json_t *values,
@@ -787,6 +898,17 @@ static struct list_constraint *conditional_constraint (struct match_ctx *mctx,
             goto error;
         }
     }
+    if (conditional_optimize (c) < 0) {
+        errprintf (errp, "Out of memory");
+        goto error;
+    }
+    /* "and" or "or" of a single term is that term
+     */
+    if (c->match != match_not && zlistx_size (c->values) == 1) {
+        struct list_constraint *cp = zlistx_detach (c->values, NULL);
+        list_constraint_destroy (c);
+        return cp;
+    }
     return c;
 
  error:
@@ -861,6 +983,52 @@ struct list_constraint *list_constraint_create (struct match_ctx *mctx,
     return list_constraint_new (mctx, match_true, NULL, errp);
 }
 
+/* Return the single value required by a userid, name, or queue
+ * constraint 'c', or NULL if there isn't exactly one value.
+ */
+static const char *constraint_single_value (struct list_constraint *c,
+                                            enum job_index_type type,
+                                            char *buf,
+                                            size_t size)
+{
+    if (zlistx_size (c->values) != 1)
+        return NULL;
+    if (type == JOB_INDEX_USERID && c->match == match_userid) {
+        uint32_t *userid = zlistx_head (c->values);
+        if (*userid == FLUX_USERID_UNKNOWN)
+            return NULL;
+        snprintf (buf, size, "%u", (unsigned int) *userid);
+        return buf;
+    }
+    if ((type == JOB_INDEX_NAME && c->match == match_name)
+        || (type == JOB_INDEX_QUEUE && c->match == match_queue))
+        return zlistx_head (c->values);
+    return NULL;
+}
+
+const char *list_constraint_index_key (struct list_constraint *c,
+                                       enum job_index_type type,
+                                       char *buf,
+                                       size_t size)
+{
+    const char *key;
+
+    if (!c)
+        return NULL;
+    if (c->match == match_and) {
+        /*  Any term of an "and" that pins the value is sufficient.
+         */
+        struct list_constraint *cp = zlistx_first (c->values);
+        while (cp) {
+            if ((key = list_constraint_index_key (cp, type, buf, size)))
+                return key;
+            cp = zlistx_next (c->values);
+        }
+        return NULL;
+    }
+    return constraint_single_value (c, type, buf, size);
+}
+
 int job_match (const struct job *job,
                struct list_constraint *constraint,
                flux_error_t *errp)
@@ -50,6 +50,18 @@ int job_match (const struct job *job,
                struct list_constraint *constraint,
                flux_error_t *errp);
 
+/*  If every job matching 'constraint' must have a single specific value
+ *   for the attribute indexed by 'type' (userid, queue, or name), return
+ *   that value in the format used for index keys (see job_state.h),
+ *   otherwise return NULL. 'buf' of length 'size' may be used to format
+ *   the result. This allows callers to scan a secondary index instead
+ *   of all jobs.
+ */
+const char *list_constraint_index_key (struct list_constraint *constraint,
+                                       enum job_index_type type,
+                                       char *buf,
+                                       size_t size);
+
 int job_match_config_reload (struct match_ctx *mctx,
                              const flux_conf_t *conf,
                              flux_error_t *errp);
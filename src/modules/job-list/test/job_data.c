@@ -866,6 +866,109 @@ static void test_R_update (void)
     free (data);
 }
 
+static struct job *compact_job_create (struct job_strpool *sp)
+{
+    struct job *job;
+
+    if (!(job = job_create (NULL, FLUX_JOBID_ANY)))
+        BAIL_OUT ("job_create failed");
+    if (parse_jobspec (job, TEST_SRCDIR "/jobspec/queue_specified.jobspec") < 0
+        || parse_R (job, TEST_SRCDIR "/R/4node_4core.R") < 0)
+        BAIL_OUT ("failed to parse jobspec or R");
+    ok (job_compact (job, sp) == 0,
+        "job_compact works");
+    return job;
+}
+
+static void test_compact (void)
+{
+    struct job_strpool *sp;
+    struct job *job1;
+    struct job *job2;
+
+    if (!(sp = job_strpool_create ()))
+        BAIL_OUT ("job_strpool_create failed");
+
+    ok (job_compact (NULL, sp) < 0 && errno == EINVAL,
+        "job_compact (NULL, sp) fails with EINVAL");
+
+    job1 = compact_job_create (sp);
+    ok (job1->jobspec == NULL && job1->R == NULL,
+        "job_compact released jobspec and R");
+    ok (job1->name && streq (job1->name, "hostname"),
+        "compacted job name is preserved");
+    ok (job1->queue && streq (job1->queue, "batch"),
+        "compacted job queue is preserved");
+    ok (job1->nnodes == 4 && streq (job1->nodelist, "node[1-4]"),
+        "compacted job nnodes and nodelist are preserved");
+    ok (job_compact (job1, sp) == 0,
+        "job_compact of compacted job is a no-op");
+
+    job2 = compact_job_create (sp);
+    ok (job1->name == job2->name && job1->queue == job2->queue,
+        "compacted jobs share interned strings");
+
+    job_destroy (job1);
+    ok (job2->name && streq (job2->name, "hostname"),
+        "interned string remains valid after first job destroyed");
+    job_destroy (job2);
+    job_strpool_destroy (sp);
+}
+
+static void test_snapshot (void)
+{
+    struct job_strpool *sp;
+    struct job *job;
+    struct job *job2;
+    json_t *o;
+    json_t *o2;
+
+    if (!(sp = job_strpool_create ()))
+        BAIL_OUT ("job_strpool_create failed");
+
+    job = compact_job_create (sp);
+    ok (job_snapshot (job) == NULL && errno == EINVAL,
+        "job_snapshot of active job fails with EINVAL");
+
+    job->state = FLUX_JOB_STATE_INACTIVE;
+    job->t_inactive = 42.5;
+    job->exception_occurred = true;
+    job->exception_type = "cancel";
+    job->result = FLUX_JOB_RESULT_CANCELED;
+    if (!(job->annotations = json_pack ("{s:{s:i}}", "user", "foo", 1)))
+        BAIL_OUT ("json_pack failed");
+    ok ((o = job_snapshot (job)) != NULL,
+        "job_snapshot works");
+    ok (json_object_get (o, "jobspec") == NULL
+        && json_object_get (o, "R") == NULL,
+        "snapshot does not include jobspec or R");
+
+    ok (job_create_from_snapshot (NULL, NULL, sp) == NULL && errno == EINVAL,
+        "job_create_from_snapshot (NULL) fails with EINVAL");
+    ok ((job2 = job_create_from_snapshot (NULL, o, sp)) != NULL,
+        "job_create_from_snapshot works");
+    ok (job2->state == FLUX_JOB_STATE_INACTIVE
+        && job2->t_inactive == 42.5
+        && job2->result == FLUX_JOB_RESULT_CANCELED,
+        "restored job has inactive state, timestamp, and result");
+    ok (job2->name == job->name && job2->queue == job->queue,
+        "restored job strings are interned");
+    ok (job2->nnodes == 4 && streq (job2->nodelist, "node[1-4]"),
+        "restored job nnodes and nodelist are preserved");
+    ok (job2->exception_type && streq (job2->exception_type, "cancel"),
+        "restored job exception type is preserved");
+    ok ((o2 = job_snapshot (job2)) != NULL && json_equal (o, o2),
+        "snapshot of restored job is identical");
+
+    json_decref (o2);
+    json_decref (o);
+    /* exception_type was not interned, do not release it */
+    job->exception_type = NULL;
+    job_destroy (job);
+    job_destroy (job2);
+    job_strpool_destroy (sp);
+}
+
 int main (int argc, char *argv[])
 {
     plan (NO_PLAN);
@@ -884,6 +987,8 @@ int main (int argc, char *argv[])
     test_ncores ();
     test_jobspec_update ();
     test_R_update ();
+    test_compact ();
+    test_snapshot ();
 
     done_testing ();
 }
@@ -15,6 +15,7 @@
 #include <flux/core.h>
 
 #include "src/common/libtap/tap.h"
+#include "src/common/libutil/monotime.h"
 #include "src/modules/job-list/job_data.h"
 #include "src/modules/job-list/match.h"
 #include "ccan/str/str.h"
@@ -2092,6 +2093,248 @@ static void test_realworld (void)
     }
 }
 
+struct index_key_test {
+    const char *constraint;
+    enum job_index_type type;
+    const char *key;
+} index_key_tests[] = {
+    { "{ \"userid\": [ 42 ] }", JOB_INDEX_USERID, "42", },
+    { "{ \"userid\": [ 42 ] }", JOB_INDEX_NAME, NULL, },
+    { "{ \"userid\": [ 42, 43 ] }", JOB_INDEX_USERID, NULL, },
+    { "{ \"userid\": [ -1 ] }", JOB_INDEX_USERID, NULL, },
+    { "{ \"name\": [ \"foo\" ] }", JOB_INDEX_NAME, "foo", },
+    { "{ \"queue\": [ \"batch\" ] }", JOB_INDEX_QUEUE, "batch", },
+    { "{ \"queue\": [ \"batch\" ] }", JOB_INDEX_NAME, NULL, },
+    {
+      "{ \"and\": [ { \"states\": [ \"inactive\" ] }, \
+                    { \"and\": [ { \"name\": [ \"foo\" ] } ] } ] }",
+      JOB_INDEX_NAME,
+      "foo",
+    },
+    {
+      "{ \"or\": [ { \"name\": [ \"foo\" ] }, \
+                   { \"name\": [ \"bar\" ] } ] }",
+      JOB_INDEX_NAME,
+      NULL,
+    },
+    /* "or" of a single term is reduced to that term */
+    {
+      "{ \"or\": [ { \"name\": [ \"foo\" ] } ] }",
+      JOB_INDEX_NAME,
+      "foo",
+    },
+    {
+      "{ \"not\": [ { \"name\": [ \"foo\" ] } ] }",
+      JOB_INDEX_NAME,
+      NULL,
+    },
+    { NULL, 0, NULL },
+};
+
+static void test_index_key (void)
+{
+    struct index_key_test *t = index_key_tests;
+    struct list_constraint *c;
+    char buf[32];
+    int index = 0;
+
+    c = create_list_constraint (NULL);
+    ok (list_constraint_index_key (c, JOB_INDEX_USERID, buf, sizeof (buf))
+        == NULL,
+        "list_constraint_index_key returns NULL for empty constraint");
+    list_constraint_destroy (c);
+
+    while (t->constraint) {
+        const char *key;
+        c = create_list_constraint (t->constraint);
+        key = list_constraint_index_key (c, t->type, buf, sizeof (buf));
+        if (t->key)
+            ok (key != NULL && streq (key, t->key),
+                "list_constraint_index_key test #%d returns %s",
+                index, t->key);
+        else
+            ok (key == NULL,
+                "list_constraint_index_key test #%d returns NULL",
+                index);
+        list_constraint_destroy (c);
+        index++;
+        t++;
+    }
+}
+
+struct nested_test {
+    const char *constraint;
+    int expected;
+} nested_tests[] = {
+    /* nested "and" terms are merged */
+    {
+      "{ \"and\": [ { \"userid\": [ 42 ] }, \
+                    { \"and\": [ { \"name\": [ \"foo\" ] }, \
+                                 { \"queue\": [ \"batch\" ] } ] } ] }",
+      1,
+    },
+    {
+      "{ \"and\": [ { \"userid\": [ 42 ] }, \
+                    { \"and\": [ { \"name\": [ \"foo\" ] }, \
+                                 { \"queue\": [ \"debug\" ] } ] } ] }",
+      0,
+    },
+    /* nested "or" terms are merged */
+    {
+      "{ \"or\": [ { \"userid\": [ 43 ] }, \
+                   { \"or\": [ { \"name\": [ \"bar\" ] }, \
+                               { \"queue\": [ \"batch\" ] } ] } ] }",
+      1,
+    },
+    /* an empty "or" is true, and is not merged into an "or" */
+    {
+      "{ \"or\": [ { \"userid\": [ 43 ] }, { \"or\": [] } ] }",
+      1,
+    },
+    /* an empty "and" is true */
+    {
+      "{ \"and\": [ { \"userid\": [ 42 ] }, { \"and\": [] } ] }",
+      1,
+    },
+    /* nested "and" terms of "not" are merged */
+    {
+      "{ \"not\": [ { \"and\": [ { \"userid\": [ 42 ] }, \
+                                   { \"name\": [ \"foo\" ] } ] } ] }",
+      0,
+    },
+    {
+      "{ \"not\": [ { \"and\": [ { \"userid\": [ 42 ] }, \
+                                   { \"name\": [ \"bar\" ] } ] } ] }",
+      1,
+    },
+    /* "or" is not merged into "not" */
+    {
+      "{ \"not\": [ { \"or\": [ { \"userid\": [ 43 ] }, \
+                                  { \"name\": [ \"foo\" ] } ] } ] }",
+      0,
+    },
+    /* expensive terms are still evaluated when cheap ones match */
+    {
+      "{ \"and\": [ { \"hostlist\": [ \"node[3-4]\" ] }, \
+                    { \"states\": [ \"running\" ] } ] }",
+      1,
+    },
+    {
+      "{ \"and\": [ { \"hostlist\": [ \"node[5-6]\" ] }, \
+                    { \"states\": [ \"running\" ] } ] }",
+      0,
+    },
+    { NULL, 0 },
+};
+
+static void test_nested_conditionals (void)
+{
+    struct nested_test *t = nested_tests;
+    struct job *job;
+    int index = 0;
+
+    job = setup_job (42,
+                     "foo",
+                     "batch",
+                     "node[1-4]",
+                     "0-3",
+                     FLUX_JOB_STATE_RUN,
+                     0,
+                     0.0,
+                     0.0,
+                     0.0,
+                     0.0,
+                     0.0);
+    while (t->constraint) {
+        struct list_constraint *c;
+        flux_error_t error;
+        int rv;
+
+        c = create_list_constraint (t->constraint);
+        rv = job_match (job, c, &error);
+        ok (rv == t->expected,
+            "nested conditional test #%d returns %d",
+            index, t->expected);
+        list_constraint_destroy (c);
+        index++;
+        t++;
+    }
+    job_destroy (job);
+}
+
+/* Filter a large number of synthetic jobs with a constraint of the kind
+ * generated by flux-jobs(1), and report the time taken.
+ */
+static void test_large (void)
+{
+    const int njobs = 1000;
+    const int iterations = 1000;
+    const char *names[] = { "foo", "bar", "baz", "sleep" };
+    const char *queues[] = { "batch", "debug" };
+    flux_job_state_t states[] = { FLUX_JOB_STATE_SCHED,
+                                  FLUX_JOB_STATE_RUN,
+                                  FLUX_JOB_STATE_INACTIVE };
+    struct job *jobs[njobs];
+    struct list_constraint *c;
+    struct timespec t0;
+    flux_error_t error;
+    int count = 0;
+    int expected = 0;
+
+    for (int i = 0; i < njobs; i++) {
+        char nodelist[64];
+        snprintf (nodelist, sizeof (nodelist), "node[%d-%d]", i, i + 3);
+        jobs[i] = setup_job (i % 8,
+                             names[i % 4],
+                             queues[i % 2],
+                             nodelist,
+                             NULL,
+                             states[i % 3],
+                             FLUX_JOB_RESULT_COMPLETED,
+                             (double) i,
+                             0.0,
+                             0.0,
+                             0.0,
+                             0.0);
+        /* userid 3 or 7, running "bar" or "sleep" in queue debug
+         * on a node in node[10-500]
+         */
+        if ((i % 8 == 3 || i % 8 == 7)
+            && states[i % 3] == FLUX_JOB_STATE_RUN
+            && i + 3 >= 10 && i <= 500)
+            expected++;
+    }
+    c = create_list_constraint (
+        "{ \"and\": [ \
+            { \"hostlist\": [ \"node[10-500]\" ] }, \
+            { \"or\": [ { \"name\": [ \"bar\" ] }, \
+                        { \"name\": [ \"sleep\" ] } ] }, \
+            { \"and\": [ { \"queue\": [ \"debug\" ] }, \
+                         { \"t_submit\": [ \">=0\" ] } ] }, \
+            { \"states\": [ \"running\" ] }, \
+            { \"userid\": [ 3, 7 ] } ] }");
+
+    monotime (&t0);
+    for (int n = 0; n < iterations; n++) {
+        for (int i = 0; i < njobs; i++) {
+            int rv = job_match (jobs[i], c, &error);
+            if (rv < 0)
+                BAIL_OUT ("job_match failed: %s", error.text);
+            count += rv;
+        }
+    }
+    diag ("filtered %d jobs in %.3fs",
+          njobs * iterations,
+          monotime_since (t0) / 1000.);
+    ok (count == expected * iterations,
+        "large filter matched %d of %d jobs",
+        count / iterations, njobs);
+
+    list_constraint_destroy (c);
+    for (int i = 0; i < njobs; i++)
+        job_destroy (jobs[i]);
+}
+
 int main (int argc, char *argv[])
 {
     plan (NO_PLAN);
@@ -2109,6 +2352,9 @@ int main (int argc, char *argv[])
     test_basic_timestamp ();
     test_basic_conditionals ();
     test_realworld ();
+    test_index_key ();
+    test_nested_conditionals ();
+    test_large ();
 
     done_testing ();
 }
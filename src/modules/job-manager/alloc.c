@@ -49,6 +49,8 @@ struct alloc {
     flux_watcher_t *idle;
     unsigned int alloc_limit;   // will have a value of 0 in mode=unlimited
     char *sched_sender;         // scheduler uuid for disconnect processing
+    bool free_batch;            // scheduler accepts batched sched.free
+    json_t *frees;              // sched.free payloads awaiting flush
 };
 
 static void requeue_pending (struct alloc *alloc, struct job *job)
@@ -68,8 +70,33 @@ static void requeue_pending (struct alloc *alloc, struct job *job)
     annotations_clear_and_publish (ctx, job, "sched");
 }
 
+/* Send one sched.free request for all frees batched in this
+ * reactor loop iteration.
+ */
+static int free_flush (struct alloc *alloc)
+{
+    flux_msg_t *msg;
+
+    if (json_array_size (alloc->frees) == 0)
+        return 0;
+    if (!(msg = flux_request_encode ("sched.free", NULL)))
+        return -1;
+    if (flux_msg_pack (msg, "{s:O}", "jobs", alloc->frees) < 0)
+        goto error;
+    if (flux_send (alloc->ctx->h, msg, 0) < 0)
+        goto error;
+    json_array_clear (alloc->frees);
+    flux_msg_destroy (msg);
+    return 0;
+error:
+    flux_msg_destroy (msg);
+    return -1;
+}
+
 /* Initiate teardown.  Clear any alloc/free requests, and clear
  * the alloc->scheduler_is_online flag to stop prep/check from allocating.
+ * Batched frees are sent first, as they would have been without batching,
+ * so resources are not lost if the scheduler is still running.
  */
 static void interface_teardown (struct alloc *alloc, char *s, int errnum)
 {
@@ -89,7 +116,11 @@ static void interface_teardown (struct alloc *alloc, char *s, int errnum)
                 requeue_pending (alloc, job);
             job = zhashx_next (ctx->active_jobs);
         }
+        if (free_flush (alloc) < 0)
+            flux_log_error (ctx->h, "alloc: error sending batched frees");
         alloc->scheduler_is_online = false;
+        alloc->free_batch = false;
+        json_array_clear (alloc->frees);
         free (alloc->sched_sender);
         alloc->sched_sender = NULL;
         drain_check (alloc->ctx->drain);
@@ -97,6 +128,8 @@ static void interface_teardown (struct alloc *alloc, char *s, int errnum)
 }
 
 /* Send sched.free request.
+ * If the scheduler accepts batched requests, defer the request to
+ * free_flush(), called from the check watcher.
  */
 int free_request (struct alloc *alloc,
                   flux_jobid_t id,
@@ -105,6 +138,19 @@ int free_request (struct alloc *alloc,
 {
     flux_msg_t *msg;
 
+    if (alloc->free_batch) {
+        json_t *o;
+        if (!(o = json_pack ("{s:I s:O s:b}",
+                             "id", id,
+                             "R", R,
+                             "final", final))
+            || json_array_append_new (alloc->frees, o) < 0) {
+            json_decref (o);
+            errno = ENOMEM;
+            return -1;
+        }
+        return 0;
+    }
     if (!(msg = flux_request_encode ("sched.free", NULL)))
         return -1;
     if (flux_msg_pack (msg,
@@ -362,15 +408,17 @@ static void ready_cb (flux_t *h,
     struct job_manager *ctx = arg;
     const char *mode;
     int limit = 0;
+    int free_batch = 0;
     int count;
     struct job *job;
     const char *sender;
 
     if (flux_request_unpack (msg,
                              NULL,
-                             "{s:s s?i}",
+                             "{s:s s?i s?b}",
                              "mode", &mode,
-                             "limit", &limit) < 0)
+                             "limit", &limit,
+                             "free-batch", &free_batch) < 0)
         goto error;
     if (streq (mode, "limited")) {
         if (limit <= 0) {
@@ -395,7 +443,12 @@ static void ready_cb (flux_t *h,
             goto error;
     }
     ctx->alloc->scheduler_is_online = true;
-    flux_log (h, LOG_DEBUG, "scheduler: ready %s", mode);
+    ctx->alloc->free_batch = free_batch ? true : false;
+    flux_log (h,
+              LOG_DEBUG,
+              "scheduler: ready %s%s",
+              mode,
+              free_batch ? " +free-batch" : "");
     count = zlistx_size (ctx->alloc->queue);
     if (flux_respond_pack (h, msg, "{s:i}", "count", count) < 0)
         flux_log_error (h, "%s: flux_respond_pack", __FUNCTION__);
@@ -442,7 +495,7 @@ static bool alloc_work_available (struct job_manager *ctx)
 
 /* prep:
  * Runs right before reactor calls poll(2).
- * If a job can be scheduled, start idle watcher.
+ * If a job can be scheduled or frees are batched, start idle watcher.
  */
 static void prep_cb (flux_reactor_t *r,
                      flux_watcher_t *w,
@@ -451,13 +504,16 @@ static void prep_cb (flux_reactor_t *r,
 {
     struct job_manager *ctx = arg;
 
-    if (alloc_work_available (ctx))
+    if (alloc_work_available (ctx)
+        || json_array_size (ctx->alloc->frees) > 0)
         flux_watcher_start (ctx->alloc->idle);
 }
 
 /* check:
  * Runs right after reactor calls poll(2).
- * Stop idle watcher, and send next alloc request, if available.
+ * Stop idle watcher, flush batched frees, and send the next alloc
+ * request, if available.  Frees are sent first so the scheduler
+ * sees released resources before new alloc requests.
  */
 static void check_cb (flux_reactor_t *r,
                       flux_watcher_t *w,
@@ -470,6 +526,12 @@ static void check_cb (flux_reactor_t *r,
 
     flux_watcher_stop (alloc->idle);
 
+    if (free_flush (alloc) < 0) {
+        flux_log_error (ctx->h, "free_flush fatal error");
+        flux_reactor_stop_error (flux_get_reactor (ctx->h));
+        return;
+    }
+
     if (!alloc_work_available (ctx))
         return;
 
@@ -733,12 +795,16 @@ void alloc_ctx_destroy (struct alloc *alloc)
 {
     if (alloc) {
         int saved_errno = errno;;
+        if (free_flush (alloc) < 0)
+            flux_log_error (alloc->ctx->h,
+                            "alloc: error sending batched frees");
         flux_msg_handler_delvec (alloc->handlers);
         flux_watcher_destroy (alloc->prep);
         flux_watcher_destroy (alloc->check);
         flux_watcher_destroy (alloc->idle);
         zlistx_destroy (&alloc->queue);
         zlistx_destroy (&alloc->sent);
+        json_decref (alloc->frees);
         free (alloc->sched_sender);
         free (alloc);
         errno = saved_errno;
@@ -783,7 +849,8 @@ struct alloc *alloc_ctx_create (struct job_manager *ctx)
         return NULL;
     alloc->ctx = ctx;
     if (!(alloc->queue = job_priority_queue_create ())
-        || !(alloc->sent = job_priority_queue_create ()))
+        || !(alloc->sent = job_priority_queue_create ())
+        || !(alloc->frees = json_array ()))
         goto error;
     if (flux_msg_handler_addvec (ctx->h, htab, ctx, &alloc->handlers) < 0)
         goto error;
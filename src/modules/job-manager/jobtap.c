@@ -665,19 +665,28 @@ void jobtap_destroy (struct jobtap *jobtap)
     }
 }
 
-static int jobtap_topic_match_count (struct jobtap *jobtap,
-                                     const char *topic)
+/*  Return the number of plugins in 'plugins' with a handler for 'topic'.
+ *  Handler matches are cached by each plugin, so this is cheap enough
+ *  to call before creating plugin args for every job transition.
+ */
+static int plugins_match_count (zlistx_t *plugins, const char *topic)
 {
     int count = 0;
-    flux_plugin_t *p = zlistx_first (jobtap->plugins);
+    flux_plugin_t *p = zlistx_first (plugins);
     while (p) {
         if (flux_plugin_match_handler (p, topic))
             count++;
-        p = zlistx_next (jobtap->plugins);
+        p = zlistx_next (plugins);
     }
     return count;
 }
 
+static int jobtap_topic_match_count (struct jobtap *jobtap,
+                                     const char *topic)
+{
+    return plugins_match_count (jobtap->plugins, topic);
+}
+
 static int jobtap_post_jobspec_updates (struct jobtap *jobtap,
                                         struct job *job)
 {
@@ -711,15 +720,32 @@ static int jobtap_stack_call (struct jobtap *jobtap,
 {
     int retcode = 0;
     flux_plugin_t *p = NULL;
+    zlistx_t *l;
 
-    /* Duplicate list to make jobtap_stack_call reentrant */
-    zlistx_t *l = zlistx_dup (plugins);
-    if (!l)
+    /* Copy plugins that handle topic to a new list, to make
+     * jobtap_stack_call reentrant and skip plugins that would ignore it.
+     */
+    if (!(l = zlistx_new ()))
         return -1;
-    zlistx_set_destructor (l, NULL);
+    p = zlistx_first (plugins);
+    while (p) {
+        if (flux_plugin_match_handler (p, topic)
+            && !zlistx_add_end (l, p)) {
+            zlistx_destroy (&l);
+            errno = ENOMEM;
+            return -1;
+        }
+        p = zlistx_next (plugins);
+    }
+    if (zlistx_size (l) == 0) {
+        zlistx_destroy (&l);
+        return 0;
+    }
 
-    if (current_job_push (jobtap, job) < 0)
+    if (current_job_push (jobtap, job) < 0) {
+        zlistx_destroy (&l);
         return -1;
+    }
     p = zlistx_first (l);
     while (p) {
         int rc = flux_plugin_call (p, topic, args);
@@ -1120,6 +1146,11 @@ int jobtap_notify_subscribers (struct jobtap *jobtap,
         return -1;
     }
 
+    /*  Avoid creating args if no subscriber handles this event.
+     */
+    if (plugins_match_count (job->subscribers, topic) == 0)
+        return 0;
+
     va_start (ap, fmt);
     args = jobtap_args_vcreate (jobtap, job, fmt, ap);
     va_end (ap);
@@ -12,8 +12,10 @@
  *
  * This allows another service to track detailed information about
  * all jobs.  The journal consumer makes a job-manager.events-journal
- * request with optional allow/deny filter and boolean 'full' flag:
- *   {"full"?b, "allow"?{"name":1, ...}, "deny"?{"name:1, ...}}
+ * request with optional allow/deny filter and boolean 'full' and 'batch'
+ * flags:
+ *   {"full"?b, "allow"?{"name":1, ...}, "deny"?{"name:1, ...},
+ *    "inactive_known"?[I, ...], "batch"?b}
  *
  * If "full" is true, the journal begins with all the inactive jobs.
  * If "full" is false, the journal begins with all the active jobs.
@@ -35,9 +37,27 @@
  * The sentinel informs the consumer that it is now caught up and that future
  * responses will be for events that are are posted in real time.
  *
+ * A consumer that has saved the state of inactive jobs may also set
+ * "inactive_known" to the ids of those jobs.  Inactive jobs in that set
+ * are then omitted from the backlog, and their ids are returned in the
+ * sentinel instead:
+ *   {"id":-1, "events":[], "inactive":[I, ...]}
+ * Since inactive jobs cannot change, this lets a restarting consumer
+ * reuse its saved state for jobs that are still retained by the job
+ * manager and discard any that were purged in the meantime.  Inactive
+ * jobs missing from its saved state are sent in the backlog as usual.
+ *
  * Additional responses contain at most one event.  The redacted jobspec is
  * included with the "submit" event.  The redacted R object is included
  * with the "alloc" event.
+ *
+ * If "batch" is true, events posted after the sentinel are instead
+ * accumulated over one reactor loop iteration and sent as an array of
+ * such responses, in the order they were posted:
+ *   {"batch":[{"id":I, "events":[], "jobspec"?s, "R"?s}, ...]}
+ * A burst of events then costs each consumer one message per reactor
+ * loop iteration rather than one per event.  The encoded payload is
+ * shared by all batching consumers that do not set allow/deny filters.
  */
 
 #if HAVE_CONFIG_H
@@ -52,6 +72,7 @@
 #include "src/common/libutil/errprintf.h"
 #include "src/common/libutil/fsd.h"
 #include "src/common/libjob/idf58.h"
+#include "src/common/libjob/job_hash.h"
 #include "ccan/str/str.h"
 
 #include "conf.h"
@@ -63,11 +84,18 @@ struct journal {
     flux_msg_handler_t **handlers;
     struct flux_msglist *listeners;
     int event_count;
+    json_t *batch;      // events pending for batching listeners
+    flux_watcher_t *prep;
+    flux_watcher_t *check;
+    flux_watcher_t *idle;
+    int batch_count;    // number of batches sent
+    int batch_max;      // largest batch sent
 };
 
 struct journal_filter { // stored as aux item in request message
     json_t *allow;      // allow, deny are owned by message
     json_t *deny;
+    int batch;
 };
 
 static bool allow_deny_check (const flux_msg_t *msg, const char *name)
@@ -97,6 +125,154 @@ static bool allow_all (const flux_msg_t *msg)
     return true;
 }
 
+static bool is_batching (const flux_msg_t *msg)
+{
+    struct journal_filter *filter = flux_msg_aux_get (msg, "filter");
+    return filter->batch ? true : false;
+}
+
+static const char *batch_entry_name (json_t *o)
+{
+    json_t *events = json_object_get (o, "events");
+    const char *name;
+
+    if (eventlog_entry_parse (json_array_get (events, 0),
+                              NULL,
+                              &name,
+                              NULL) < 0)
+        return NULL;
+    return name;
+}
+
+/* Encode the subset of batched events 'batch' that pass the allow/deny
+ * filter of 'msg'.  Return NULL with errno == ENOENT if none pass.
+ */
+static char *batch_encode_filtered (const flux_msg_t *msg, json_t *batch)
+{
+    json_t *filtered;
+    json_t *o = NULL;
+    size_t index;
+    json_t *entry;
+    char *s = NULL;
+
+    if (!(filtered = json_array ()))
+        goto nomem;
+    json_array_foreach (batch, index, entry) {
+        const char *name = batch_entry_name (entry);
+        if (name && allow_deny_check (msg, name)) {
+            if (json_array_append (filtered, entry) < 0)
+                goto nomem;
+        }
+    }
+    if (json_array_size (filtered) == 0) {
+        json_decref (filtered);
+        errno = ENOENT;
+        return NULL;
+    }
+    if (!(o = json_pack ("{s:O}", "batch", filtered))
+        || !(s = json_dumps (o, JSON_COMPACT)))
+        goto nomem;
+    json_decref (o);
+    json_decref (filtered);
+    return s;
+nomem:
+    json_decref (o);
+    json_decref (filtered);
+    errno = ENOMEM;
+    return NULL;
+}
+
+/* Send pending events to batching listeners.  The payload is encoded
+ * once for all listeners without filters.
+ */
+static int journal_flush (struct journal *journal)
+{
+    flux_t *h = journal->ctx->h;
+    size_t count = json_array_size (journal->batch);
+    const flux_msg_t *msg;
+    char *s_all = NULL;
+    int rc = -1;
+
+    if (count == 0)
+        return 0;
+    msg = flux_msglist_first (journal->listeners);
+    while (msg) {
+        if (is_batching (msg)) {
+            if (allow_all (msg)) {
+                if (!s_all) {
+                    json_t *o;
+                    if (!(o = json_pack ("{s:O}", "batch", journal->batch))
+                        || !(s_all = json_dumps (o, JSON_COMPACT))) {
+                        json_decref (o);
+                        errno = ENOMEM;
+                        goto done;
+                    }
+                    json_decref (o);
+                }
+                if (flux_respond (h, msg, s_all) < 0)
+                    flux_log_error (h,
+                                    "error responding to"
+                                    " job-manager.events-journal request");
+            }
+            else {
+                char *s;
+                if (!(s = batch_encode_filtered (msg, journal->batch))) {
+                    if (errno != ENOENT)
+                        goto done;
+                }
+                else {
+                    if (flux_respond (h, msg, s) < 0)
+                        flux_log_error (h,
+                                        "error responding to"
+                                        " job-manager.events-journal request");
+                    free (s);
+                }
+            }
+        }
+        msg = flux_msglist_next (journal->listeners);
+    }
+    journal->batch_count++;
+    if (journal->batch_max < count)
+        journal->batch_max = count;
+    rc = 0;
+done:
+    json_array_clear (journal->batch);
+    free (s_all);
+    return rc;
+}
+
+/* prep:
+ * Runs right before reactor calls poll(2).
+ * If events are pending, start idle watcher so poll does not block.
+ */
+static void prep_cb (flux_reactor_t *r,
+                     flux_watcher_t *w,
+                     int revents,
+                     void *arg)
+{
+    struct journal *journal = arg;
+
+    if (json_array_size (journal->batch) > 0)
+        flux_watcher_start (journal->idle);
+}
+
+/* check:
+ * Runs right after reactor calls poll(2).
+ * Stop idle watcher and flush pending events to batching listeners.
+ */
+static void check_cb (flux_reactor_t *r,
+                      flux_watcher_t *w,
+                      int revents,
+                      void *arg)
+{
+    struct journal *journal = arg;
+
+    flux_watcher_stop (journal->idle);
+
+    if (journal_flush (journal) < 0)
+        flux_log_error (journal->ctx->h, "error flushing journal batch");
+}
+
 int journal_process_event (struct journal *journal,
                            flux_jobid_t id,
                            const char *name,
@@ -104,6 +280,8 @@ int journal_process_event (struct journal *journal,
 {
     struct job_manager *ctx = journal->ctx;
     const flux_msg_t *msg;
+    bool batching = false;
+    char *s = NULL;
     json_t *o;
 
     if (!(o = json_pack ("{s:I s:[O]}",
@@ -127,14 +305,22 @@ int journal_process_event (struct journal *journal,
     journal->event_count++;
     msg = flux_msglist_first (journal->listeners);
     while (msg) {
-        if (allow_deny_check (msg, name)
-            && flux_respond_pack (ctx->h, msg, "O", o) < 0) {
-            flux_log_error (ctx->h,
-                            "error responding to"
-                            " job-manager.events-journal request");
+        if (is_batching (msg))
+            batching = true;
+        else if (allow_deny_check (msg, name)) {
+            if (!s && !(s = json_dumps (o, JSON_COMPACT)))
+                goto error;
+            if (flux_respond (ctx->h, msg, s) < 0) {
+                flux_log_error (ctx->h,
+                                "error responding to"
+                                " job-manager.events-journal request");
+            }
         }
         msg = flux_msglist_next (journal->listeners);
     }
+    if (batching && json_array_append (journal->batch, o) < 0)
+        goto error;
+    free (s);
     json_decref (o);
     return 0;
 error:
@@ -142,6 +328,7 @@ error:
                     "error preparing journal response for %s %s",
                     idf58 (id),
                     name);
+    free (s);
     json_decref (o);
     return 0;
 }
@@ -207,10 +394,14 @@ static int send_job_events (struct job_manager *ctx,
  */
 static int send_backlog (struct job_manager *ctx,
                          const flux_msg_t *msg,
-                         bool full)
+                         bool full,
+                         json_t *inactive_known)
 {
     struct job *job;
     int job_count = zhashx_size (ctx->active_jobs);
+    zhashx_t *known = NULL;
+    json_t *inactive = NULL;
+    json_t *o = NULL;
 
     if (full)
         job_count += zhashx_size (ctx->inactive_jobs);
@@ -223,17 +414,36 @@ static int send_backlog (struct job_manager *ctx,
     }
 
     if (full) {
+        if (inactive_known) {
+            size_t index;
+            json_t *entry;
+
+            if (!(known = job_hash_create ())
+                || !(inactive = json_array ()))
+                goto nomem;
+            json_array_foreach (inactive_known, index, entry) {
+                flux_jobid_t id = json_integer_value (entry);
+                (void)zhashx_insert (known, &id, entry);
+            }
+        }
         job = zhashx_first (ctx->inactive_jobs);
         while (job) {
-            if (send_job_events (ctx, msg, job) < 0)
-                return -1;
+            if (known && zhashx_lookup (known, &job->id)) {
+                json_t *id = json_integer (job->id);
+                if (!id || json_array_append_new (inactive, id) < 0) {
+                    json_decref (id);
+                    goto nomem;
+                }
+            }
+            else if (send_job_events (ctx, msg, job) < 0)
+                goto error;
             job = zhashx_next (ctx->inactive_jobs);
         }
     }
     job = zhashx_first (ctx->active_jobs);
     while (job) {
         if (send_job_events (ctx, msg, job) < 0)
-            return -1;
+            goto error;
         job = zhashx_next (ctx->active_jobs);
     }
 
@@ -245,13 +455,23 @@ static int send_backlog (struct job_manager *ctx,
     /* Send a special response with id = FLUX_JOB_ANY to demarcate the
      * backlog from ongoing events.  The consumer may ignore this message.
      */
-    if (flux_respond_pack (ctx->h,
-                           msg,
-                           "{s:I s:[]}",
-                           "id", FLUX_JOBID_ANY,
-                           "events") < 0)
-        return -1;
+    if (!(o = json_pack ("{s:I s:[]}", "id", FLUX_JOBID_ANY, "events")))
+        goto nomem;
+    if (inactive && json_object_set (o, "inactive", inactive) < 0)
+        goto nomem;
+    if (flux_respond_pack (ctx->h, msg, "O", o) < 0)
+        goto error;
+    json_decref (o);
+    json_decref (inactive);
+    zhashx_destroy (&known);
     return 0;
+nomem:
+    errno = ENOMEM;
+error:
+    ERRNO_SAFE_WRAP (json_decref, o);
+    ERRNO_SAFE_WRAP (json_decref, inactive);
+    ERRNO_SAFE_WRAP (zhashx_destroy, &known);
+    return -1;
 }
 
 static void journal_handle_request (flux_t *h,
@@ -264,16 +484,19 @@ static void journal_handle_request (flux_t *h,
     struct journal *journal = ctx->journal;
     struct journal_filter *filter;
     int full = 0;
+    json_t *inactive_known = NULL;
     const char *errstr = NULL;
 
     if (!(filter = calloc (1, sizeof (*filter))))
         goto error;
     if (flux_request_unpack (msg,
                              &topic,
-                             "{s?o s?o s?b}",
+                             "{s?o s?o s?b s?o s?b}",
                              "allow", &filter->allow,
                              "deny", &filter->deny,
-                             "full", &full) < 0
+                             "full", &full,
+                             "inactive_known", &inactive_known,
+                             "batch", &filter->batch) < 0
         || flux_msg_aux_set (msg, "filter", filter,
                              (flux_free_f)filter_destroy) < 0) {
         filter_destroy (filter);
@@ -297,7 +520,18 @@ static void journal_handle_request (flux_t *h,
         goto error;
     }
 
-    if (send_backlog (ctx, msg, full) < 0) {
+    if (inactive_known && !json_is_array (inactive_known)) {
+        errno = EPROTO;
+        errstr = "job-manager.events inactive_known should be an array";
+        goto error;
+    }
+
+    /* Pending events are already in the backlog of this listener,
+     * so send them to existing listeners before adding it.
+     */
+    if (journal_flush (journal) < 0)
+        flux_log_error (h, "error flushing journal batch");
+    if (send_backlog (ctx, msg, full, inactive_known) < 0) {
         flux_log_error (h, "error responding to %s", topic);
         return;
     }
@@ -313,9 +547,13 @@ json_t *journal_get_stats (struct journal *journal)
 {
     json_t *o;
 
-    o = json_pack ("{s:i s:i}",
+    o = json_pack ("{s:i s:i s:{s:i s:i s:i}}",
                    "listeners", flux_msglist_count (journal->listeners),
-                   "events", journal->event_count);
+                   "events", journal->event_count,
+                   "batch",
+                     "count", journal->batch_count,
+                     "max", journal->batch_max,
+                     "pending", (int)json_array_size (journal->batch));
 
     return o;
 }
@@ -347,9 +585,14 @@ void journal_ctx_destroy (struct journal *journal)
         flux_t *h = journal->ctx->h;
 
         flux_msg_handler_delvec (journal->handlers);
+        flux_watcher_destroy (journal->prep);
+        flux_watcher_destroy (journal->check);
+        flux_watcher_destroy (journal->idle);
         if (journal->listeners) {
             const flux_msg_t *msg;
 
+            if (journal->batch && journal_flush (journal) < 0)
+                flux_log_error (h, "error flushing journal batch");
             msg = flux_msglist_first (journal->listeners);
             while (msg) {
                 if (flux_respond_error (h, msg, ENODATA, NULL) < 0)
@@ -359,6 +602,7 @@ void journal_ctx_destroy (struct journal *journal)
             }
             flux_msglist_destroy (journal->listeners);
         }
+        json_decref (journal->batch);
         free (journal);
         errno = saved_errno;
     }
@@ -383,6 +627,7 @@ static const struct flux_msg_handler_spec htab[] = {
 struct journal *journal_ctx_create (struct job_manager *ctx)
 {
     struct journal *journal;
+    flux_reactor_t *r = flux_get_reactor (ctx->h);
 
     if (!(journal = calloc (1, sizeof (*journal))))
         return NULL;
@@ -391,6 +636,18 @@ struct journal *journal_ctx_create (struct job_manager *ctx)
         goto error;
     if (!(journal->listeners = flux_msglist_create ()))
         goto error;
+    journal->prep = flux_prepare_watcher_create (r, prep_cb, journal);
+    journal->check = flux_check_watcher_create (r, check_cb, journal);
+    journal->idle = flux_idle_watcher_create (r, NULL, NULL);
+    if (!(journal->batch = json_array ())
+        || !journal->prep
+        || !journal->check
+        || !journal->idle) {
+        errno = ENOMEM;
+        goto error;
+    }
+    flux_watcher_start (journal->prep);
+    flux_watcher_start (journal->check);
     return journal;
 error:
     journal_ctx_destroy (journal);
@@ -62,6 +62,10 @@
  *   Force rediscovery of local resources via hwloc. Do not fetch R or hwloc
  *   XML from the enclosing instance.
  *
+ * topo-cache = "/path"
+ *   Cache discovered hwloc XML in this directory and reuse it when the
+ *   local hardware signature is unchanged.
+ *
  * journal-max = 100000
  *   Maximum size allowed of the resource journal before it is truncated.
  */
@@ -75,6 +79,7 @@ static int parse_config (struct resource_ctx *ctx,
     const char *exclude  = NULL;
     const char *path = NULL;
     const char *scheduling_path = NULL;
+    const char *topo_cache = NULL;
     int noverify = 0;
     int norestrict = 0;
     int no_update_watch = 0;
@@ -85,7 +90,7 @@ static int parse_config (struct resource_ctx *ctx,
 
     if (flux_conf_unpack (conf,
                           &error,
-                          "{s?{s?s s?s s?o s?s s?b s?b s?b s?b s?i !}}",
+                          "{s?{s?s s?s s?o s?s s?b s?b s?b s?b s?i s?s !}}",
                           "resource",
                             "path", &path,
                             "scheduling", &scheduling_path,
@@ -95,7 +100,8 @@ static int parse_config (struct resource_ctx *ctx,
                             "noverify", &noverify,
                             "no-update-watch", &no_update_watch,
                             "rediscover", &rediscover,
-                            "journal-max", &journal_max) < 0) {
+                            "journal-max", &journal_max,
+                            "topo-cache", &topo_cache) < 0) {
         errprintf (errp,
                    "error parsing [resource] configuration: %s",
                    error.text);
@@ -167,6 +173,7 @@ static int parse_config (struct resource_ctx *ctx,
         rconfig->norestrict = norestrict ? true : false;
         rconfig->no_update_watch = no_update_watch ? true : false;
         rconfig->rediscover = rediscover ? true : false;
+        rconfig->topo_cache = topo_cache;
         rconfig->R = o;
         rconfig->systemd_enable = systemd_enable ? true : false;
     }
@@ -14,6 +14,7 @@
 struct resource_config {
     json_t *R;
     const char *exclude_idset;
+    const char *topo_cache;
     bool rediscover;
     bool noverify;
     bool norestrict;
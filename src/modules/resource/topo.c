@@ -15,11 +15,21 @@
  *
  * Reduce r_local from each rank, leaving the result in topo->reduce->rl
  * on rank 0.  If resources are not known, then this R is set in inventory.
+ *
+ * If resource.topo-cache is configured, discovered (unrestricted) XML is
+ * saved to <topo-cache>/<hostname>.json along with a cheap hardware
+ * signature, and reused on subsequent module loads if the signature matches,
+ * avoiding full hwloc discovery.
  */
 
 #if HAVE_CONFIG_H
 #include "config.h"
 #endif
+#include <unistd.h>
+#include <dirent.h>
+#include <stdio.h>
+#include <sys/utsname.h>
+#include <sys/sysinfo.h>
 #include <jansson.h>
 #include <flux/core.h>
 
@@ -275,6 +285,163 @@ void topo_destroy (struct topo *topo)
     }
 }
 
+/* Count entries in /sys/bus/pci/devices so that added or removed
+ * devices (e.g. GPUs) invalidate a cached topology.
+ */
+static int count_pci_devices (void)
+{
+    DIR *dir;
+    struct dirent *dent;
+    int count = 0;
+
+    if (!(dir = opendir ("/sys/bus/pci/devices")))
+        return -1;
+    while ((dent = readdir (dir))) {
+        if (dent->d_name[0] != '.')
+            count++;
+    }
+    closedir (dir);
+    return count;
+}
+
+/* Build a hardware signature that is cheap to compute relative to
+ * hwloc discovery.
+ */
+static char *topo_cache_signature (void)
+{
+    struct utsname u;
+    struct sysinfo si;
+    char *s;
+
+    if (uname (&u) < 0 || sysinfo (&si) < 0)
+        return NULL;
+    if (asprintf (&s,
+                  "%s %s %s %s ncpus=%ld mem=%ju pci=%d hwloc=%x",
+                  u.nodename,
+                  u.machine,
+                  u.release,
+                  u.version,
+                  sysconf (_SC_NPROCESSORS_CONF),
+                  (uintmax_t)si.totalram * si.mem_unit,
+                  count_pci_devices (),
+                  (unsigned int)HWLOC_API_VERSION) < 0)
+        return NULL;
+    return s;
+}
+
+static char *topo_cache_path (const char *dir)
+{
+    struct utsname u;
+    char *path;
+
+    if (uname (&u) < 0
+        || asprintf (&path, "%s/%s.json", dir, u.nodename) < 0)
+        return NULL;
+    return path;
+}
+
+/* Return cached unrestricted XML if the cache entry exists and its
+ * signature matches 'signature', otherwise NULL.
+ */
+static char *topo_cache_load (struct resource_ctx *ctx,
+                              const char *path,
+                              const char *signature)
+{
+    json_t *o;
+    const char *sig;
+    const char *xml;
+    char *result = NULL;
+
+    if (!(o = json_load_file (path, 0, NULL)))
+        return NULL;
+    if (json_unpack (o, "{s:s s:s}", "signature", &sig, "xml", &xml) < 0) {
+        flux_log (ctx->h, LOG_ERR, "%s: invalid topology cache entry", path);
+        goto out;
+    }
+    if (!streq (sig, signature)) {
+        flux_log (ctx->h,
+                  LOG_INFO,
+                  "%s: hardware signature changed, rediscovering",
+                  path);
+        goto out;
+    }
+    result = strdup (xml);
+out:
+    json_decref (o);
+    return result;
+}
+
+static int topo_cache_store (const char *path,
+                             const char *signature,
+                             const char *xml)
+{
+    json_t *o;
+    char *tmp = NULL;
+    int rc = -1;
+
+    if (!(o = json_pack ("{s:s s:s}", "signature", signature, "xml", xml))) {
+        errno = ENOMEM;
+        return -1;
+    }
+    if (asprintf (&tmp, "%s.%ju", path, (uintmax_t)getpid ()) < 0)
+        goto out;
+    if (json_dump_file (o, tmp, JSON_COMPACT) < 0) {
+        errno = EIO;
+        goto out;
+    }
+    if (rename (tmp, path) < 0) {
+        ERRNO_SAFE_WRAP (unlink, tmp);
+        goto out;
+    }
+    rc = 0;
+out:
+    ERRNO_SAFE_WRAP (free, tmp);
+    ERRNO_SAFE_WRAP (json_decref, o);
+    return rc;
+}
+
+/* Discover the local topology with hwloc, or fetch it from the topology
+ * cache if configured.  The cache holds unrestricted XML so it remains
+ * valid if the broker's CPU binding changes.
+ */
+static char *topo_discover_xml (struct resource_ctx *ctx,
+                                struct resource_config *config)
+{
+    rhwloc_flags_t flags = config->norestrict ? RHWLOC_NO_RESTRICT : 0;
+    char *signature = NULL;
+    char *path = NULL;
+    char *xml = NULL;
+    char *result;
+
+    if (!config->topo_cache)
+        return rhwloc_local_topology_xml (flags);
+
+    if (!(signature = topo_cache_signature ())
+        || !(path = topo_cache_path (config->topo_cache))) {
+        flux_log_error (ctx->h, "topo-cache: error computing signature");
+        free (signature);
+        return rhwloc_local_topology_xml (flags);
+    }
+    if (!config->rediscover
+        && (xml = topo_cache_load (ctx, path, signature))) {
+        flux_log (ctx->h, LOG_DEBUG, "loaded hwloc XML from %s", path);
+    }
+    else {
+        if (!(xml = rhwloc_local_topology_xml (RHWLOC_NO_RESTRICT)))
+            goto out;
+        if (topo_cache_store (path, signature, xml) < 0)
+            flux_log_error (ctx->h, "topo-cache: error writing %s", path);
+    }
+out:
+    free (signature);
+    free (path);
+    if (!xml || config->norestrict)
+        return xml;
+    result = rhwloc_topology_xml_restrict (xml);
+    free (xml);
+    return result;
+}
+
 static char *topo_get_local_xml (struct resource_ctx *ctx,
                                  struct resource_config *config)
 {
@@ -292,7 +459,6 @@ static char *topo_get_local_xml (struct resource_ctx *ctx,
                            FLUX_NODEID_ANY,
                            0))
         || flux_rpc_get (f, &xml) < 0) {
-        rhwloc_flags_t flags = config->norestrict ? RHWLOC_NO_RESTRICT : 0;
         /*  ENOENT just means there is no parent instance.
          *  No need for an error.
          */
@@ -301,7 +467,7 @@ static char *topo_get_local_xml (struct resource_ctx *ctx,
                       LOG_DEBUG,
                       "resource.topo-get to parent failed: %s",
                       strerror (errno));
-        result = rhwloc_local_topology_xml (flags);
+        result = topo_discover_xml (ctx, config);
         goto out;
     }
     flux_log (ctx->h,
@@ -20,6 +20,7 @@
 #include "src/common/libjob/job.h"
 #include "src/common/libjob/jj.h"
 #include "src/common/libjob/idf58.h"
+#include "src/common/libjob/job_hash.h"
 #include "src/common/librlist/rlist.h"
 #include "ccan/str/str.h"
 
@@ -53,6 +54,7 @@ struct simple_sched {
     int schedutil_flags;
     struct rlist *rlist;    /* list of resources */
     zlistx_t *queue;        /* job queue */
+    zhashx_t *jobs;         /* index of queued jobs by id */
     schedutil_t *util_ctx;
 
     flux_watcher_t *prep;
@@ -94,14 +96,15 @@ static int jobreq_cmp (const void *x, const void *y)
 static struct jobreq *
 jobreq_find (struct simple_sched *ss, flux_jobid_t id)
 {
-    struct jobreq *job;
-    job = zlistx_first (ss->queue);
-    while (job) {
-        if (job->id == id)
-            return job;
-        job = zlistx_next (ss->queue);
-    }
-    return NULL;
+    return zhashx_lookup (ss->jobs, &id);
+}
+
+/*  Remove job from the queue and the job index, destroying it.
+ */
+static void jobreq_dequeue (struct simple_sched *ss, struct jobreq *job)
+{
+    zhashx_delete (ss->jobs, &job->id);
+    zlistx_delete (ss->queue, job->handle);
 }
 
 static struct jobreq *
@@ -161,6 +164,7 @@ static void simple_sched_destroy (flux_t *h, struct simple_sched *ss)
             }
             zlistx_destroy (&ss->queue);
         }
+        zhashx_destroy (&ss->jobs);
         flux_future_destroy (ss->acquire_f);
         flux_watcher_destroy (ss->prep);
         flux_watcher_destroy (ss->check);
@@ -185,7 +189,7 @@ static struct simple_sched * simple_sched_create (void)
      */
     ss->alloc_limit = 8;
 
-    ss->schedutil_flags = SCHEDUTIL_HELLO_PARTIAL_OK;
+    ss->schedutil_flags = SCHEDUTIL_HELLO_PARTIAL_OK | SCHEDUTIL_FREE_BATCH;
     return ss;
 }
 
@@ -283,7 +287,7 @@ static int try_alloc (flux_t *h, struct simple_sched *ss)
     rc = 0;
 
 out:
-    zlistx_delete (ss->queue, job->handle);
+    jobreq_dequeue (ss, job);
     rlist_destroy (alloc);
     free (R);
     free (s);
@@ -449,6 +453,15 @@ static void alloc_cb (flux_t *h, const flux_msg_t *msg, void *arg)
               job->jj.duration);
 
     search_dir = job->priority > FLUX_JOB_URGENCY_DEFAULT;
+    if (zhashx_insert (ss->jobs, &job->id, job) < 0) {
+        flux_log (h,
+                  LOG_ERR,
+                  "alloc: duplicate request for %s",
+                  idf58 (job->id));
+        jobreq_destroy (job);
+        errno = EEXIST;
+        goto err;
+    }
     job->handle = zlistx_insert (ss->queue, job, search_dir);
     flux_watcher_start (ss->prep);
     return;
@@ -477,7 +490,7 @@ static void cancel_cb (flux_t *h, const flux_msg_t *msg, void *arg)
             flux_log_error (h, "alloc_respond_cancel");
             return;
         }
-        zlistx_delete (ss->queue, job->handle);
+        jobreq_dequeue (ss, job);
         annotate_reason_pending (ss);
     }
 }
@@ -981,6 +994,9 @@ static int process_args (flux_t *h, struct simple_sched *ss,
         else if (streq (argv[i], "test-hello-nopartial")) {
             ss->schedutil_flags &= ~SCHEDUTIL_HELLO_PARTIAL_OK;
         }
+        else if (streq (argv[i], "test-free-nobatch")) {
+            ss->schedutil_flags &= ~SCHEDUTIL_FREE_BATCH;
+        }
         else {
             flux_log_error (h, "Unknown module option: '%s'", argv[i]);
             errno = EINVAL;
@@ -1037,6 +1053,8 @@ int mod_main (flux_t *h, int argc, char **argv)
         goto done;
     zlistx_set_comparator (ss->queue, jobreq_cmp);
     zlistx_set_destructor (ss->queue, jobreq_destructor);
+    if (!(ss->jobs = job_hash_create ()))
+        goto done;
 
     /* Let `flux module load simple-sched` return before synchronous
      * initialization with resource and job-manager modules.
@@ -27,6 +27,30 @@
  *   plugin hook, which allows the level of one or more logging
  *   plugins to be set independently of the main shell log
  *   facility level.
+ *
+ *  Between shell.init and shell.start in a multi-shell job, other
+ *   shells forward log messages to the leader shell "log" service
+ *   instead of committing them directly. The leader holds its own
+ *   messages and those forwarded by other shells, and merges those from
+ *   different shells that differ only in shell rank into a single event,
+ *   so that e.g. the same startup warning on every node results in one
+ *   event and one commit. Repeats from the same shell are kept as
+ *   separate events.
+ *
+ *  The leader only handles forwarded messages once its reactor runs,
+ *   after the start barrier, so the merge window is coalesce_timeout
+ *   from the first reactor loop iteration. Held messages are written
+ *   when the window closes, or at shell.exit, and later messages are
+ *   written directly.
+ *
+ *  The "rank" of a merged event is an RFC 22 idset string of the shell
+ *   ranks, e.g. "0-3", rather than the integer rank of an RFC 24 log
+ *   event. Messages from one shell keep an integer rank.
+ *
+ *  Forwarding stops at shell.start since the leader may exit before
+ *   other shells once the start barrier is complete. FATAL
+ *   messages are always written directly, as is any message the leader
+ *   fails to accept.
  */
 #define FLUX_SHELL_PLUGIN_NAME "evlog"
 
@@ -36,7 +60,9 @@
 #include <jansson.h>
 #include <flux/core.h>
 #include <flux/shell.h>
+#include <flux/idset.h>
 
+#include "src/common/libczmqcontainers/czmq_containers.h"
 #include "src/common/libeventlog/eventlogger.h"
 #include "ccan/str/str.h"
 
@@ -44,38 +70,276 @@
 #include "internal.h"
 #include "builtins.h"
 
+/*  Time the leader holds log messages to merge them across shells,
+ *   once its reactor is running.
+ */
+static const double coalesce_timeout = 0.1;
+
+/*  Time to wait for the leader to accept a forwarded log message before
+ *   writing it directly.
+ */
+static const double forward_timeout = 5.;
+
+struct evlog_pending {
+    json_t *context;            // log event context, without rank
+    struct idset *ranks;        // shell ranks that logged this message
+};
+
 struct evlog {
     int sync_mode;
     int level;
     flux_shell_t *shell;
     struct eventlogger *ev;
+
+    bool forward;               // forward messages to leader shell
+    bool merge;                 // merge messages from all shells (leader)
+    bool window;                // merge window timer is running
+    zhashx_t *pending_hash;     // key -> struct evlog_pending
+    zlistx_t *pending;          // struct evlog_pending in arrival order
+    flux_watcher_t *timer;
 };
 
+static void evlog_pending_destroy (void **item)
+{
+    if (item && *item) {
+        struct evlog_pending *pe = *item;
+        json_decref (pe->context);
+        idset_destroy (pe->ranks);
+        free (pe);
+        *item = NULL;
+    }
+}
+
+static int evlog_write (struct evlog *evlog, int flags, json_t *context)
+{
+    char *s;
+    int rc;
+
+    if (!(s = json_dumps (context, JSON_COMPACT)))
+        return -1;
+    rc = eventlogger_append (evlog->ev, flags, "output", "log", s);
+    free (s);
+    return rc;
+}
+
+/*  Write all merged log messages held by the leader.  A message from a
+ *   single shell keeps an integer rank, as if it had not been held.
+ */
+static void evlog_pending_flush (struct evlog *evlog)
+{
+    struct evlog_pending *pe;
+
+    if (!evlog->pending || zlistx_size (evlog->pending) == 0)
+        return;
+    pe = zlistx_first (evlog->pending);
+    while (pe) {
+        json_t *rank = NULL;
+        char *ranks = NULL;
+
+        if (idset_count (pe->ranks) == 1)
+            rank = json_integer (idset_first (pe->ranks));
+        else if ((ranks = idset_encode (pe->ranks, IDSET_FLAG_RANGE)))
+            rank = json_string (ranks);
+        if (!rank
+            || json_object_set_new (pe->context, "rank", rank) < 0
+            || evlog_write (evlog, 0, pe->context) < 0)
+            fprintf (stderr, "evlog: failed to write merged log message\n");
+        free (ranks);
+        pe = zlistx_next (evlog->pending);
+    }
+    zhashx_purge (evlog->pending_hash);
+    zlistx_purge (evlog->pending);
+}
+
+/*  Close the merge window: write held messages and stop merging.
+ */
+static void evlog_merge_stop (struct evlog *evlog)
+{
+    if (!evlog->merge)
+        return;
+    evlog->merge = false;
+    flux_watcher_stop (evlog->timer);
+    evlog_pending_flush (evlog);
+    flux_shell_remove_completion_ref (evlog->shell, "evlog.pending");
+}
+
+/*  The timer is first armed with a zero timeout at shell.start, so that
+ *   it fires on the first reactor loop iteration.  Start the merge window
+ *   then, since forwarded messages cannot be received any earlier.
+ */
+static void pending_timer_cb (flux_reactor_t *r,
+                              flux_watcher_t *w,
+                              int revents,
+                              void *arg)
+{
+    struct evlog *evlog = arg;
+
+    if (!evlog->window) {
+        evlog->window = true;
+        flux_timer_watcher_reset (w, coalesce_timeout, 0.);
+        flux_watcher_start (w);
+        return;
+    }
+    evlog_merge_stop (evlog);
+}
+
+static struct idset *evlog_ranks_decode (json_t *rank)
+{
+    struct idset *ids = NULL;
+
+    if (json_is_integer (rank) && json_integer_value (rank) >= 0) {
+        if ((ids = idset_create (0, IDSET_FLAG_AUTOGROW))
+            && idset_set (ids, json_integer_value (rank)) < 0) {
+            idset_destroy (ids);
+            return NULL;
+        }
+        return ids;
+    }
+    if (json_is_string (rank))
+        ids = idset_decode (json_string_value (rank));
+    if (!ids || idset_count (ids) == 0) {
+        idset_destroy (ids);
+        errno = EPROTO;
+        return NULL;
+    }
+    return ids;
+}
+
+/*  Hold a log message on the leader, merging it with the most recent
+ *   held message that differs only in rank, unless that message already
+ *   includes one of its ranks, i.e. it is a repeat from the same shell.
+ */
+static int evlog_pending_add (struct evlog *evlog, json_t *context)
+{
+    struct evlog_pending *pe;
+    struct idset *ranks;
+    json_t *o = NULL;
+    char *key = NULL;
+    int rc = -1;
+
+    if (!json_is_object (context)
+        || !(ranks = evlog_ranks_decode (json_object_get (context, "rank"))))
+        return -1;
+    if (!(o = json_copy (context))
+        || json_object_del (o, "rank") < 0
+        || !(key = json_dumps (o, JSON_COMPACT | JSON_SORT_KEYS))) {
+        errno = ENOMEM;
+        goto out;
+    }
+    if ((pe = zhashx_lookup (evlog->pending_hash, key))
+        && !idset_has_intersection (pe->ranks, ranks)) {
+        if (idset_add (pe->ranks, ranks) < 0)
+            goto out;
+    }
+    else {
+        if (!(pe = calloc (1, sizeof (*pe))))
+            goto out;
+        pe->context = json_incref (o);
+        pe->ranks = ranks;
+        ranks = NULL;
+        if (!zlistx_add_end (evlog->pending, pe)) {
+            evlog_pending_destroy ((void **) &pe);
+            errno = ENOMEM;
+            goto out;
+        }
+        zhashx_update (evlog->pending_hash, key, pe);
+    }
+    rc = 0;
+out:
+    idset_destroy (ranks);
+    free (key);
+    json_decref (o);
+    return rc;
+}
+
+static void log_request_cb (flux_t *h,
+                            flux_msg_handler_t *mh,
+                            const flux_msg_t *msg,
+                            void *arg)
+{
+    struct evlog *evlog = arg;
+    json_t *context;
+
+    if (flux_request_unpack (msg, NULL, "o", &context) < 0)
+        goto error;
+    /*  A message sent before the sending shell's shell.start may arrive
+     *   after the leader's, so write it directly once merging has stopped.
+     */
+    if (evlog->merge) {
+        if (evlog_pending_add (evlog, context) < 0)
+            goto error;
+    }
+    else if (evlog_write (evlog, 0, context) < 0)
+        goto error;
+    if (flux_respond (h, msg, NULL) < 0)
+        fprintf (stderr, "evlog: error responding to log request\n");
+    return;
+error:
+    if (flux_respond_error (h, msg, errno, NULL) < 0)
+        fprintf (stderr, "evlog: error responding to log request\n");
+}
+
+/*  If the leader could not take a forwarded message, write it directly.
+ */
+static void forward_continuation (flux_future_t *f, void *arg)
+{
+    struct evlog *evlog = arg;
+    json_t *context = flux_future_aux_get (f, "evlog::context");
+
+    if (flux_future_get (f, NULL) < 0
+        && evlog_write (evlog, 0, context) < 0)
+        fprintf (stderr, "evlog: failed to write log message\n");
+    flux_future_destroy (f);
+    flux_shell_remove_completion_ref (evlog->shell, "evlog.forward");
+}
+
+static int evlog_forward (struct evlog *evlog, json_t *context)
+{
+    flux_future_t *f;
+
+    if (!(f = flux_shell_rpc_pack (evlog->shell, "log", 0, 0, "O", context))
+        || flux_future_aux_set (f,
+                                "evlog::context",
+                                json_incref (context),
+                                (flux_free_f) json_decref) < 0
+        || flux_future_then (f,
+                             forward_timeout,
+                             forward_continuation,
+                             evlog) < 0) {
+        flux_future_destroy (f);
+        return -1;
+    }
+    flux_shell_add_completion_ref (evlog->shell, "evlog.forward");
+    return 0;
+}
+
 static int log_eventlog (flux_plugin_t *p,
                          const char *topic,
                          flux_plugin_arg_t *args,
                          void *data)
 {
-    int flags = 0;
-    int rc = 0;
     int level = -1;
-    char *context = NULL;
+    json_t *context;
     struct evlog *evlog = NULL;
 
     if (!(evlog = flux_plugin_aux_get (p, "evlog")))
         return -1;
     if (flux_plugin_arg_unpack (args, FLUX_PLUGIN_ARG_IN,
-                                "{s:i}", "level", &level) < 0)
+                                "{s:i}", "level", &level) < 0
+        || flux_plugin_arg_unpack (args, FLUX_PLUGIN_ARG_IN,
+                                   "o", &context) < 0)
         return -1;
     if (level > evlog->level)
         return 0;
-    if (evlog->sync_mode || level == FLUX_SHELL_FATAL)
-        flags = EVENTLOGGER_FLAG_WAIT;
-    if (flux_plugin_arg_get (args, FLUX_PLUGIN_ARG_IN, &context) < 0
-        || eventlogger_append (evlog->ev, flags, "output", "log", context) < 0)
-        rc = -1;
-    free (context);
-    return rc;
+    if (evlog->sync_mode || level == FLUX_SHELL_FATAL) {
+        evlog_pending_flush (evlog);
+        return evlog_write (evlog, EVENTLOGGER_FLAG_WAIT, context);
+    }
+    if (evlog->forward && evlog_forward (evlog, context) == 0)
+        return 0;
+    if (evlog->merge && evlog_pending_add (evlog, context) == 0)
+        return 0;
+    return evlog_write (evlog, 0, context);
 }
 
 static void evlog_destroy (struct evlog *evlog)
@@ -83,6 +347,10 @@ static void evlog_destroy (struct evlog *evlog)
     /*  Redirect future logging to stderr */
     flux_shell_log_setlevel (evlog->level, "stderr");
 
+    evlog_pending_flush (evlog);
+    flux_watcher_destroy (evlog->timer);
+    zhashx_destroy (&evlog->pending_hash);
+    zlistx_destroy (&evlog->pending);
     eventlogger_flush (evlog->ev);
     eventlogger_destroy (evlog->ev);
     free (evlog);
@@ -113,6 +381,7 @@ static int log_eventlog_reconnect (flux_plugin_t *p,
      */
 
     while (flux_shell_remove_completion_ref (shell, "eventlogger.txn") == 0);
+    while (flux_shell_remove_completion_ref (shell, "evlog.forward") == 0);
 
     return 0;
 }
@@ -194,9 +463,65 @@ static int evlog_shell_exit (flux_plugin_t *p,
      *   there will no longer be a reactor.
      */
     evlog->sync_mode = 1;
+    evlog_merge_stop (evlog);
     return 0;
 }
 
+static int evlog_shell_start (flux_plugin_t *p,
+                              const char *topic,
+                              flux_plugin_arg_t *args,
+                              void *data)
+{
+    struct evlog *evlog = data;
+    evlog->forward = false;
+    if (evlog->merge) {
+        flux_timer_watcher_reset (evlog->timer, 0., 0.);
+        flux_watcher_start (evlog->timer);
+        flux_shell_add_completion_ref (evlog->shell, "evlog.pending");
+    }
+    return 0;
+}
+
+/*  Once the shell rank is known, forward log messages to the leader
+ *   shell, or on the leader, start merging log messages from all shells.
+ */
+static int evlog_shell_init (flux_plugin_t *p,
+                             const char *topic,
+                             flux_plugin_arg_t *args,
+                             void *data)
+{
+    struct evlog *evlog = data;
+    flux_t *h = flux_shell_get_flux (evlog->shell);
+    int shell_rank;
+    int shell_size;
+
+    if (flux_shell_info_unpack (evlog->shell,
+                                "{s:i s:i}",
+                                "rank", &shell_rank,
+                                "size", &shell_size) < 0)
+        return -1;
+    if (shell_size == 1)
+        return 0;
+    if (shell_rank > 0) {
+        evlog->forward = true;
+        return 0;
+    }
+    if (!(evlog->pending_hash = zhashx_new ())
+        || !(evlog->pending = zlistx_new ())
+        || !(evlog->timer = flux_timer_watcher_create (flux_get_reactor (h),
+                                                       coalesce_timeout,
+                                                       0.,
+                                                       pending_timer_cb,
+                                                       evlog)))
+        return -1;
+    zlistx_set_destructor (evlog->pending, evlog_pending_destroy);
+    evlog->merge = true;
+    return flux_shell_service_register (evlog->shell,
+                                        "log",
+                                        log_request_cb,
+                                        evlog);
+}
+
 /*  Start the eventlog-based logger during shell.connect, just after the
  *   shell has obtained a flux_t handle. This allows more early log
  *   messages to make it into the eventlog, but some data (such as
@@ -219,6 +544,12 @@ static int log_eventlog_start (flux_plugin_t *p,
        || flux_plugin_add_handler (p, "shell.log-setlevel",
                                    log_eventlog_setlevel,
                                    evlog) < 0
+       || flux_plugin_add_handler (p, "shell.init",
+                                   evlog_shell_init,
+                                   evlog) < 0
+       || flux_plugin_add_handler (p, "shell.start",
+                                   evlog_shell_start,
+                                   evlog) < 0
        || flux_plugin_add_handler (p, "shell.exit",
                                    evlog_shell_exit,
                                    evlog) < 0)
@@ -15,10 +15,17 @@
  * RPCs.
  *
  * Notes:
+ *  - Output and log entries are aggregated for up to batch_timeout
+ *    seconds, or until batch_max bytes of output are pending, and then
+ *    sent to the leader in a single "write" RPC.
+ *  - If the output.compress shell option is set, batches of at least
+ *    compress_threshold bytes are LZ4 compressed and sent to the
+ *    "write-lz4" method instead.
  *  - Errors from write requests to leader shell are logged.
  *  - Outstanding RPCs at shell exit are waited for synchronously.
- *  - Number of in-flight write RPCs is limited by shell_output_hwm
- *    to avoid matchtag exhaustion.
+ *  - Bytes in flight to the leader are limited by shell_output_hwm.
+ *    When the limit is reached, reading from local tasks is paused
+ *    until the leader catches up to shell_output_lwm.
  */
 #if HAVE_CONFIG_H
 #include "config.h"
@@ -28,23 +35,40 @@
  */
 #define FLUX_SHELL_PLUGIN_NAME "output.client"
 
+#include <arpa/inet.h>
+#include <lz4.h>
+
 #include "src/common/libioencode/ioencode.h"
+#include "src/common/libutil/errno_safe.h"
 #include "ccan/str/str.h"
 
 #include "internal.h"
 #include "info.h"
+#include "svc.h"
 #include "output/client.h"
 
-static const int shell_output_lwm = 100;
-static const int shell_output_hwm = 1000;
+static const size_t shell_output_lwm = 1024*1024;
+static const size_t shell_output_hwm = 8*1024*1024;
+
+static const double batch_timeout = 0.01;
+static const size_t batch_max = 65536;
+static const size_t compress_threshold = 256;
 
 struct output_client {
     flux_shell_t *shell;
     int shell_rank;
     bool stopped;
     zlist_t *pending_writes;
+    size_t inflight;            // bytes sent to leader, not yet acked
+
+    json_t *batch;              // entries not yet sent
+    size_t batch_size;
+    flux_watcher_t *timer;
+    bool compress;
 };
 
+static int client_flush (struct output_client *client);
+
 static void client_send_eof (struct output_client *client)
 {
     /* Note: client should not be instantiated on rank 0, but check here
@@ -73,6 +97,8 @@ void output_client_destroy (struct output_client *client)
     if (client) {
         int saved_errno = errno;
 
+        if (client_flush (client) < 0)
+            shell_log_errno ("error writing output to leader");
         client_send_eof (client);
 
         if (client->pending_writes) {
@@ -84,19 +110,48 @@ void output_client_destroy (struct output_client *client)
             }
         }
         zlist_destroy (&client->pending_writes);
+        flux_watcher_destroy (client->timer);
+        json_decref (client->batch);
         free (client);
         errno = saved_errno;
     }
 }
 
+static void batch_timer_cb (flux_reactor_t *r,
+                            flux_watcher_t *w,
+                            int revents,
+                            void *arg)
+{
+    struct output_client *client = arg;
+    if (client_flush (client) < 0)
+        shell_log_errno ("error writing output to leader");
+}
+
 struct output_client *output_client_create (flux_shell_t *shell)
 {
     struct output_client *client;
+    flux_reactor_t *r = flux_get_reactor (shell->h);
+    int compress = 0;
+
+    if (flux_shell_getopt_unpack (shell,
+                                  "output",
+                                  "{s?i}",
+                                  "compress", &compress) < 0) {
+        shell_log_error ("invalid output.compress option");
+        return NULL;
+    }
     if (!(client = calloc (1, sizeof (*client)))
-        || !(client->pending_writes = zlist_new ()))
+        || !(client->pending_writes = zlist_new ())
+        || !(client->batch = json_array ())
+        || !(client->timer = flux_timer_watcher_create (r,
+                                                        batch_timeout,
+                                                        0.,
+                                                        batch_timer_cb,
+                                                        client)))
         goto out;
     client->shell = shell;
     client->shell_rank = shell->info->shell_rank;
+    client->compress = compress;
     return client;
 out:
     output_client_destroy (client);
@@ -115,54 +170,151 @@ static void output_client_control (struct output_client *client, bool stop)
 
             if (stop) {
                 flux_subprocess_stream_stop (p, "stdout");
-                flux_subprocess_stream_stop (p, "stdout");
+                flux_subprocess_stream_stop (p, "stderr");
             }
             else {
                 flux_subprocess_stream_start (p, "stdout");
-                flux_subprocess_stream_start (p, "stdout");
+                flux_subprocess_stream_start (p, "stderr");
             }
             task = flux_shell_task_next (client->shell);
         }
+        client->stopped = stop;
     }
 }
 
 static void output_send_cb (flux_future_t *f, void *arg)
 {
     struct output_client *client = arg;
+    size_t size = (uintptr_t)flux_future_aux_get (f, "size");
+
     if (flux_future_get (f, NULL) < 0 && errno != ENOSYS)
         shell_log_errno ("error writing output to leader");
     zlist_remove (client->pending_writes, f);
     flux_future_destroy (f);
 
-    if (zlist_size (client->pending_writes) <= shell_output_lwm)
+    client->inflight -= size;
+    if (client->inflight <= shell_output_lwm)
         output_client_control (client, false);
 }
 
-int output_client_send (struct output_client *client,
-                        const char *type,
-                        json_t *context)
+/* Send batch LZ4 compressed, prefixed by its uncompressed size
+ * in network byte order.
+ */
+static flux_future_t *send_compressed (struct output_client *client,
+                                       const char *s,
+                                       size_t len)
 {
+    int bound = LZ4_compressBound (len);
+    uint32_t size = htonl (len);
+    char *buf;
+    int n;
     flux_future_t *f = NULL;
 
-    if (!(f = flux_shell_rpc_pack (client->shell,
-                                   "write",
-                                   0,
-                                   0,
-                                   "{s:s s:i s:O}",
-                                   "name", type,
-                                   "shell_rank", client->shell_rank,
-                                   "context", context))
+    if (!(buf = malloc (sizeof (size) + bound)))
+        return NULL;
+    memcpy (buf, &size, sizeof (size));
+    if ((n = LZ4_compress_default (s, buf + sizeof (size), len, bound)) <= 0)
+        errno = EINVAL;
+    else
+        f = shell_svc_raw (client->shell->svc,
+                           "write-lz4",
+                           0,
+                           0,
+                           buf,
+                           sizeof (size) + n);
+    ERRNO_SAFE_WRAP (free, buf);
+    return f;
+}
+
+static flux_future_t *send_batch (struct output_client *client)
+{
+    json_t *o;
+    char *s;
+    size_t len;
+    flux_future_t *f = NULL;
+
+    if (!client->compress || client->batch_size < compress_threshold)
+        return flux_shell_rpc_pack (client->shell,
+                                    "write",
+                                    0,
+                                    0,
+                                    "{s:i s:O}",
+                                    "shell_rank", client->shell_rank,
+                                    "entries", client->batch);
+    if (!(o = json_pack ("{s:i s:O}",
+                         "shell_rank", client->shell_rank,
+                         "entries", client->batch))
+        || !(s = json_dumps (o, JSON_COMPACT))) {
+        json_decref (o);
+        errno = ENOMEM;
+        return NULL;
+    }
+    len = strlen (s);
+    f = send_compressed (client, s, len);
+    ERRNO_SAFE_WRAP (free, s);
+    json_decref (o);
+    return f;
+}
+
+/* Send pending entries to the leader shell.
+ */
+static int client_flush (struct output_client *client)
+{
+    flux_future_t *f = NULL;
+    size_t size = client->batch_size;
+
+    flux_watcher_stop (client->timer);
+    if (json_array_size (client->batch) == 0)
+        return 0;
+    if (!(f = send_batch (client))
+        || flux_future_aux_set (f, "size", (void *)(uintptr_t)size, NULL) < 0
         || flux_future_then (f, -1., output_send_cb, client) < 0)
         goto error;
+    json_array_clear (client->batch);
+    client->batch_size = 0;
     if (zlist_append (client->pending_writes, f) < 0)
         shell_log_error ("failed to append pending write");
-    if (zlist_size (client->pending_writes) >= shell_output_hwm)
+    client->inflight += size;
+    if (client->inflight >= shell_output_hwm)
         output_client_control (client, true);
     return 0;
 error:
     flux_future_destroy (f);
+    json_array_clear (client->batch);
+    client->batch_size = 0;
     return -1;
+}
 
+/* Approximate size of an entry, dominated by output data, if any.
+ */
+static size_t entry_size (json_t *context)
+{
+    return json_string_length (json_object_get (context, "data")) + 64;
+}
+
+int output_client_send (struct output_client *client,
+                        const char *type,
+                        json_t *context)
+{
+    json_t *entry;
+
+    if (!(entry = json_pack ("{s:s s:O}",
+                             "name", type,
+                             "context", context))
+        || json_array_append (client->batch, entry) < 0) {
+        json_decref (entry);
+        errno = ENOMEM;
+        return -1;
+    }
+    json_decref (entry);
+    client->batch_size += entry_size (context);
+    if (client->batch_size >= batch_max)
+        return client_flush (client);
+    if (!flux_watcher_is_active (client->timer)) {
+        flux_timer_watcher_reset (client->timer, batch_timeout, 0.);
+        flux_watcher_start (client->timer);
+    }
+    return 0;
 }
 
 /* vi: ts=4 sw=4 expandtab
@@ -21,6 +21,12 @@
  *    single vs multiuser instances (see SINGLEUSER_OUTPUT_LIMIT
  *    and MULTIUSER_OUTPUT_LIMIT below) Output is truncated once
  *    the limit is reached and a warning is logged.
+ *  - Consecutive data events for the same stream and rank are coalesced
+ *    into one event of up to COALESCE_MAX bytes.  Coalesced data is held
+ *    for at most COALESCE_TIMEOUT seconds (or the batch timeout, if less),
+ *    and is written before any other event, so ordering is preserved.
+ *    This reduces the number of events, and the per-event JSON overhead
+ *    paid by the KVS and by every reader of the output eventlog.
  */
 #if HAVE_CONFIG_H
 #include "config.h"
@@ -44,12 +50,26 @@
 
 #define DEFAULT_BATCH_TIMEOUT 0.5
 
+#define COALESCE_TIMEOUT 0.05
+#define COALESCE_MAX 65536
+
 #define SINGLEUSER_OUTPUT_LIMIT "1G"
 #define MULTIUSER_OUTPUT_LIMIT  "10M"
 #define OUTPUT_LIMIT_MAX        1073741824
 /* 104857600 = 100M */
 #define OUTPUT_LIMIT_WARNING    104857600
 
+/* Data held for coalescing with subsequent data from the same
+ * stream and rank.
+ */
+struct pending_data {
+    char *stream;
+    char *rank;
+    char *data;
+    int len;
+    flux_watcher_t *timer;
+};
+
 struct kvs_output {
     flux_shell_t *shell;
     int ntasks;
@@ -58,8 +78,100 @@ struct kvs_output {
     size_t stdout_bytes;
     size_t stderr_bytes;
     struct eventlogger *ev;
+    struct pending_data pending;
+    double coalesce_timeout;
 };
 
+/* Write pending data, if any, to the eventlog, with 'eof' if set.
+ */
+static int kvs_output_write_pending (struct kvs_output *kvs, bool eof)
+{
+    struct pending_data *pd = &kvs->pending;
+    json_t *context;
+    int rc = -1;
+
+    if (!pd->stream)
+        return 0;
+    flux_watcher_stop (pd->timer);
+    if (!(context = ioencode (pd->stream, pd->rank, pd->data, pd->len, eof)))
+        shell_log_errno ("ioencode");
+    else if ((rc = eventlogger_append_pack (kvs->ev,
+                                            0,
+                                            "output",
+                                            "data",
+                                            "O",
+                                            context)) < 0)
+        shell_log_errno ("eventlogger_append_pack");
+    json_decref (context);
+    free (pd->stream);
+    free (pd->rank);
+    free (pd->data);
+    pd->stream = pd->rank = pd->data = NULL;
+    pd->len = 0;
+    flux_shell_remove_completion_ref (kvs->shell, "output.pending");
+    return rc;
+}
+
+static void pending_timer_cb (flux_reactor_t *r,
+                              flux_watcher_t *w,
+                              int revents,
+                              void *arg)
+{
+    kvs_output_write_pending (arg, false);
+}
+
+/* Take ownership of 'data' and hold it for coalescing.
+ */
+static int kvs_output_set_pending (struct kvs_output *kvs,
+                                   const char *stream,
+                                   const char *rank,
+                                   char *data,
+                                   int len)
+{
+    struct pending_data *pd = &kvs->pending;
+
+    if (!(pd->stream = strdup (stream))
+        || !(pd->rank = strdup (rank))) {
+        free (pd->stream);
+        pd->stream = NULL;
+        free (data);
+        return -1;
+    }
+    pd->data = data;
+    pd->len = len;
+    flux_shell_add_completion_ref (kvs->shell, "output.pending");
+    flux_timer_watcher_reset (pd->timer, kvs->coalesce_timeout, 0.);
+    flux_watcher_start (pd->timer);
+    return 0;
+}
+
+/* Append 'data' to pending data.  Return true if it was added, or false
+ * if it doesn't belong with the pending data or there is no room for it.
+ */
+static bool kvs_output_add_pending (struct kvs_output *kvs,
+                                    const char *stream,
+                                    const char *rank,
+                                    const char *data,
+                                    int len)
+{
+    struct pending_data *pd = &kvs->pending;
+    char *buf;
+
+    if (!pd->stream
+        || !streq (pd->stream, stream)
+        || !streq (pd->rank, rank)
+        || pd->len + len > COALESCE_MAX)
+        return false;
+    if (len > 0) {
+        if (!(buf = realloc (pd->data, pd->len + len)))
+            return false;
+        memcpy (buf + pd->len, data, len);
+        pd->data = buf;
+        pd->len += len;
+    }
+    return true;
+}
+
 static void kvs_output_truncation_warning (struct kvs_output *kvs)
 {
     if (kvs->stderr_bytes > kvs->limit_bytes) {
@@ -90,6 +202,7 @@ static void kvs_output_truncation_warning (struct kvs_output *kvs)
 
 void kvs_output_flush (struct kvs_output *kvs)
 {
+    (void)kvs_output_write_pending (kvs, false);
     if (eventlogger_flush (kvs->ev) < 0)
         shell_log_errno ("eventlogger_flush");
 }
@@ -106,8 +219,12 @@ void kvs_output_destroy (struct kvs_output *kvs)
 {
     if (kvs) {
         int saved_errno = errno;
-        if (kvs->ev && eventlogger_flush (kvs->ev) < 0)
-            shell_log_errno ("eventlogger_flush");
+        if (kvs->ev) {
+            (void)kvs_output_write_pending (kvs, false);
+            if (eventlogger_flush (kvs->ev) < 0)
+                shell_log_errno ("eventlogger_flush");
+        }
+        flux_watcher_destroy (kvs->pending.timer);
         eventlogger_destroy (kvs->ev);
         free (kvs);
         errno = saved_errno;
@@ -221,6 +338,7 @@ struct kvs_output *kvs_output_create (flux_shell_t *shell)
 {
     struct kvs_output *kvs;
     double batch_timeout = DEFAULT_BATCH_TIMEOUT;
+    flux_reactor_t *r = flux_get_reactor (flux_shell_get_flux (shell));
 
     if (flux_shell_getopt_unpack (shell,
                                   "output",
@@ -236,6 +354,17 @@ struct kvs_output *kvs_output_create (flux_shell_t *shell)
     kvs->shell = shell;
     kvs->ntasks = shell->info->total_ntasks;
 
+    kvs->coalesce_timeout = COALESCE_TIMEOUT;
+    if (batch_timeout < kvs->coalesce_timeout)
+        kvs->coalesce_timeout = batch_timeout;
+    if (!(kvs->pending.timer =
+              flux_timer_watcher_create (r,
+                                         kvs->coalesce_timeout,
+                                         0.,
+                                         pending_timer_cb,
+                                         kvs)))
+        goto error;
+
     if (get_output_limit (kvs) < 0
         || kvs_eventlogger_start (kvs, batch_timeout) < 0
         || write_kvs_header (kvs) < 0)
@@ -314,15 +443,44 @@ int kvs_output_write_entry (struct kvs_output *kvs,
     int len = 0;
     bool eof;
     const char *stream = "stdout";
-    bool truncate = false;
+    const char *rank;
+    char *data = NULL;
 
-    if (streq (type, "data")
-        && iodecode (context, &stream, NULL, NULL, &len, &eof) == 0) {
-        truncate = check_kvs_output_limit (kvs, stream, len);
+    if (!streq (type, "data")
+        || iodecode (context, &stream, &rank, &data, &len, &eof) < 0) {
+        if (kvs_output_write_pending (kvs, false) < 0)
+            return -1;
+        return eventlogger_append_pack (kvs->ev,
+                                        0,
+                                        "output",
+                                        type,
+                                        "O",
+                                        context);
+    }
+    if (check_kvs_output_limit (kvs, stream, len) && !eof) {
+        free (data);
+        return 0;
     }
-    if (truncate && !eof)
+    if (kvs_output_add_pending (kvs, stream, rank, data, len)) {
+        free (data);
+        if (eof)
+            return kvs_output_write_pending (kvs, true);
         return 0;
-    return eventlogger_append_pack (kvs->ev, 0, "output", type, "O", context);
+    }
+    if (kvs_output_write_pending (kvs, false) < 0) {
+        free (data);
+        return -1;
+    }
+    if (eof || len == 0) {
+        free (data);
+        return eventlogger_append_pack (kvs->ev,
+                                        0,
+                                        "output",
+                                        type,
+                                        "O",
+                                        context);
+    }
+    return kvs_output_set_pending (kvs, stream, rank, data, len);
 }
 
 void kvs_output_reconnect (struct kvs_output *kvs)
@@ -16,7 +16,9 @@
  *
  * Clients may send an RFC 24 encoded data event, and "eof" event
  * to indicate no more output is forthcoming, or a "log" event for
- * propagation of log messages from other job shells.
+ * propagation of log messages from other job shells.  Clients normally
+ * send an "entries" array of such events in one request, optionally
+ * LZ4 compressed and sent to the "write-lz4" method.
  *
  * Local task and logging output is not routed through this service
  * code.
@@ -34,6 +36,9 @@
 #endif
 
 #include <errno.h>
+#include <string.h>
+#include <arpa/inet.h>
+#include <lz4.h>
 
 #define FLUX_SHELL_PLUGIN_NAME "output.service"
 
@@ -41,6 +46,7 @@
 #include <flux/shell.h>
 #include <flux/idset.h>
 
+#include "src/common/libutil/errno_safe.h"
 #include "ccan/str/str.h"
 
 #include "output/output.h"
@@ -94,29 +100,130 @@ static int output_service_write (struct output_service *service,
     return shell_output_write_entry (service->out, type, o);
 }
 
+static int output_service_write_entries (struct output_service *service,
+                                         int shell_rank,
+                                         json_t *entries)
+{
+    size_t index;
+    json_t *entry;
+    int rc = 0;
+
+    if (!json_is_array (entries)) {
+        errno = EPROTO;
+        return -1;
+    }
+    json_array_foreach (entries, index, entry) {
+        const char *type;
+        json_t *o;
+
+        if (json_unpack (entry,
+                         "{s:s s:o}",
+                         "name", &type,
+                         "context", &o) < 0) {
+            errno = EPROTO;
+            return -1;
+        }
+        if (output_service_write (service, type, shell_rank, o) < 0)
+            rc = -1;
+    }
+    return rc;
+}
+
+static int output_service_write_request (struct output_service *service,
+                                         json_t *request)
+{
+    int shell_rank;
+    json_t *entries = NULL;
+    json_t *o = NULL;
+    const char *type = NULL;
+
+    if (json_unpack (request,
+                     "{s:i s?o s?s s?o}",
+                     "shell_rank", &shell_rank,
+                     "entries", &entries,
+                     "name", &type,
+                     "context", &o) < 0) {
+        errno = EPROTO;
+        return -1;
+    }
+    if (entries)
+        return output_service_write_entries (service, shell_rank, entries);
+    if (!type || !o) {
+        errno = EPROTO;
+        return -1;
+    }
+    return output_service_write (service, type, shell_rank, o);
+}
+
 static void output_service_write_cb (flux_t *h,
                                      flux_msg_handler_t *mh,
                                      const flux_msg_t *msg,
                                      void *arg)
 {
     struct output_service *service = arg;
-    int shell_rank;
     json_t *o;
-    const char *type;
-
-    if (flux_request_unpack (msg,
-                             NULL,
-                             "{s:s s:i s:o}",
-                             "name", &type,
-                             "shell_rank", &shell_rank,
-                             "context", &o) < 0)
+
+    if (flux_request_unpack (msg, NULL, "o", &o) < 0
+        || output_service_write_request (service, o) < 0)
         goto error;
-    if (output_service_write (service, type, shell_rank, o) < 0)
+    if (flux_respond (h, msg, NULL) < 0)
+        shell_log_errno ("flux_respond");
+    return;
+error:
+    if (flux_respond_error (h, msg, errno, NULL) < 0)
+        shell_log_errno ("flux_respond");
+}
+
+/* Decompress a "write-lz4" payload: the uncompressed size in network
+ * byte order followed by an LZ4 compressed "write" request.
+ */
+static json_t *decompress_request (const void *data, size_t len)
+{
+    uint32_t size;
+    char *buf;
+    json_t *o;
+
+    if (len < sizeof (size)) {
+        errno = EPROTO;
+        return NULL;
+    }
+    memcpy (&size, data, sizeof (size));
+    size = ntohl (size);
+    if (!(buf = malloc (size)))
+        return NULL;
+    if (LZ4_decompress_safe ((const char *)data + sizeof (size),
+                             buf,
+                             len - sizeof (size),
+                             size) != size
+        || !(o = json_loadb (buf, size, 0, NULL))) {
+        free (buf);
+        errno = EPROTO;
+        return NULL;
+    }
+    free (buf);
+    return o;
+}
+
+static void output_service_write_lz4_cb (flux_t *h,
+                                         flux_msg_handler_t *mh,
+                                         const flux_msg_t *msg,
+                                         void *arg)
+{
+    struct output_service *service = arg;
+    const void *data;
+    size_t len;
+    json_t *o = NULL;
+
+    if (flux_request_decode_raw (msg, NULL, &data, &len) < 0
+        || !(o = decompress_request (data, len))
+        || output_service_write_request (service, o) < 0)
         goto error;
+    json_decref (o);
     if (flux_respond (h, msg, NULL) < 0)
         shell_log_errno ("flux_respond");
     return;
 error:
+    ERRNO_SAFE_WRAP (json_decref, o);
     if (flux_respond_error (h, msg, errno, NULL) < 0)
         shell_log_errno ("flux_respond");
 }
@@ -169,6 +276,10 @@ struct output_service *output_service_create (struct shell_output *out,
         || flux_shell_service_register (out->shell,
                                         "write",
                                         output_service_write_cb,
+                                        service) < 0
+        || flux_shell_service_register (out->shell,
+                                        "write-lz4",
+                                        output_service_write_lz4_cb,
                                         service) < 0)
         goto error;
 
@@ -0,0 +1,335 @@
+/************************************************************\
+ * Copyright 2026 Lawrence Livermore National Security, LLC
+ * (c.f. AUTHORS, NOTICE.LLNS, COPYING)
+ *
+ * This file is part of the Flux resource manager framework.
+ * For details, see https://github.com/flux-framework.
+ *
+ * SPDX-License-Identifier: LGPL-3.0
+\************************************************************/
+
+/* pmi_direct.c - store keys on home shells and fetch them on demand
+ *
+ * Each key has a home shell, selected by a hash of the key name, which
+ * is the same on all shells.  At a PMI barrier, each shell sends the
+ * keys put since the last barrier to their home shells, at most one
+ * "pmi-put" request per home shell.  When a task gets a key that is not
+ * cached locally, a "pmi-get" request is sent to the key's home shell.
+ *
+ * Thus, the data sent at each barrier and the memory held by each shell
+ * grow with the number of keys put and actually read, rather than with
+ * the number of shells times the number of keys.
+ *
+ * PMI-1 keys do not name the rank that put them, so the owning task
+ * cannot be found directly from the task map.  Hashing gives every shell
+ * the same answer without any additional exchange.
+ */
+#define FLUX_SHELL_PLUGIN_NAME "pmi-simple"
+
+#if HAVE_CONFIG_H
+#include "config.h"
+#endif
+#include <stdlib.h>
+#include <stdio.h>
+#include <jansson.h>
+#include <flux/core.h>
+#include <flux/shell.h>
+
+#include "info.h"
+#include "internal.h"
+
+#include "pmi_direct.h"
+
+struct pmi_direct {
+    flux_shell_t *shell;
+    int size;
+    int rank;
+    json_t *store;              // keys for which this shell is home
+
+    flux_future_t *put_f;       // pending pmi-put requests
+    pmi_direct_put_f put_cb;
+    void *put_arg;
+};
+
+struct get_request {
+    struct pmi_direct *pd;
+    pmi_direct_get_f cb;
+    void *arg;
+};
+
+/* FNV-1a hash of 'key', to select its home shell.
+ */
+static int home_rank (struct pmi_direct *pd, const char *key)
+{
+    uint32_t hash = 2166136261u;
+
+    while (*key) {
+        hash ^= (unsigned char)*key++;
+        hash *= 16777619u;
+    }
+    return hash % pd->size;
+}
+
+static int store_update (struct pmi_direct *pd, json_t *dict)
+{
+    const char *key;
+    json_t *val;
+
+    json_object_foreach (dict, key, val) {
+        if (!json_is_string (val)) {
+            errno = EPROTO;
+            return -1;
+        }
+    }
+    if (json_object_update (pd->store, dict) < 0) {
+        errno = ENOMEM;
+        return -1;
+    }
+    return 0;
+}
+
+/* PMI implementation on another shell is storing keys here.
+ */
+static void put_request_cb (flux_t *h,
+                            flux_msg_handler_t *mh,
+                            const flux_msg_t *msg,
+                            void *arg)
+{
+    struct pmi_direct *pd = arg;
+    json_t *dict;
+
+    if (flux_request_unpack (msg, NULL, "o", &dict) < 0
+        || store_update (pd, dict) < 0)
+        goto error;
+    if (flux_respond (h, msg, NULL) < 0)
+        shell_warn ("error responding to pmi-put request");
+    return;
+error:
+    if (flux_respond_error (h, msg, errno, NULL) < 0)
+        shell_warn ("error responding to pmi-put request");
+}
+
+/* PMI implementation on another shell is fetching a key stored here.
+ */
+static void get_request_cb (flux_t *h,
+                            flux_msg_handler_t *mh,
+                            const flux_msg_t *msg,
+                            void *arg)
+{
+    struct pmi_direct *pd = arg;
+    const char *key;
+    const char *val;
+
+    if (flux_request_unpack (msg, NULL, "{s:s}", "key", &key) < 0)
+        goto error;
+    if (!(val = json_string_value (json_object_get (pd->store, key)))) {
+        errno = ENOENT;
+        goto error;
+    }
+    if (flux_respond_pack (h, msg, "{s:s}", "value", val) < 0)
+        shell_warn ("error responding to pmi-get request");
+    return;
+error:
+    if (flux_respond_error (h, msg, errno, NULL) < 0)
+        shell_warn ("error responding to pmi-get request");
+}
+
+static void put_continuation (flux_future_t *f, void *arg)
+{
+    struct pmi_direct *pd = arg;
+    pmi_direct_put_f cb = pd->put_cb;
+    const char *name;
+    int rc = 0;
+
+    name = flux_future_first_child (f);
+    while (name) {
+        flux_future_t *child = flux_future_get_child (f, name);
+
+        if (flux_future_get (child, NULL) < 0) {
+            shell_warn ("pmi-put to shell %s: %s",
+                        name,
+                        future_strerror (child, errno));
+            rc = -1;
+        }
+        name = flux_future_next_child (f);
+    }
+    flux_future_destroy (f);
+    pd->put_f = NULL;
+    pd->put_cb = NULL;
+    cb (pd, rc, pd->put_arg);
+}
+
+/* Split 'dict' by home shell.  Returns an array of pd->size dicts,
+ * with NULL entries for shells that are home to none of the keys.
+ */
+static json_t **split_dict (struct pmi_direct *pd, json_t *dict)
+{
+    json_t **dicts;
+    const char *key;
+    json_t *val;
+
+    if (!(dicts = calloc (pd->size, sizeof (dicts[0]))))
+        return NULL;
+    json_object_foreach (dict, key, val) {
+        int rank = home_rank (pd, key);
+
+        if (!dicts[rank] && !(dicts[rank] = json_object ()))
+            goto nomem;
+        if (json_object_set (dicts[rank], key, val) < 0)
+            goto nomem;
+    }
+    return dicts;
+nomem:
+    for (int i = 0; i < pd->size; i++)
+        json_decref (dicts[i]);
+    free (dicts);
+    errno = ENOMEM;
+    return NULL;
+}
+
+int pmi_direct_put (struct pmi_direct *pd,
+                    json_t *dict,
+                    pmi_direct_put_f cb,
+                    void *arg)
+{
+    json_t **dicts;
+    flux_future_t *f = NULL;
+    int rc = -1;
+
+    if (pd->put_f) {
+        errno = EINPROGRESS;
+        return -1;
+    }
+    if (!(dicts = split_dict (pd, dict)))
+        return -1;
+    if (!(f = flux_future_wait_all_create ()))
+        goto done;
+    flux_future_set_flux (f, pd->shell->h);
+    for (int i = 0; i < pd->size; i++) {
+        flux_future_t *f_put;
+        char name[16];
+
+        if (!dicts[i])
+            continue;
+        if (i == pd->rank) {
+            if (store_update (pd, dicts[i]) < 0)
+                goto done;
+            continue;
+        }
+        snprintf (name, sizeof (name), "%d", i);
+        if (!(f_put = flux_shell_rpc_pack (pd->shell,
+                                           "pmi-put",
+                                           i,
+                                           0,
+                                           "O",
+                                           dicts[i])))
+            goto done;
+        if (flux_future_push (f, name, f_put) < 0) {
+            flux_future_destroy (f_put);
+            goto done;
+        }
+    }
+    pd->put_cb = cb;
+    pd->put_arg = arg;
+    if (flux_future_then (f, -1., put_continuation, pd) < 0)
+        goto done;
+    pd->put_f = f;
+    f = NULL;
+    rc = 0;
+done:
+    for (int i = 0; i < pd->size; i++)
+        json_decref (dicts[i]);
+    free (dicts);
+    flux_future_destroy (f);
+    return rc;
+}
+
+static void get_continuation (flux_future_t *f, void *arg)
+{
+    struct get_request *req = arg;
+    const char *val = NULL;
+
+    if (flux_rpc_get_unpack (f, "{s:s}", "value", &val) < 0
+        && errno != ENOENT)
+        shell_warn ("pmi-get: %s", future_strerror (f, errno));
+    req->cb (req->pd, val, req->arg);
+    flux_future_destroy (f);
+}
+
+int pmi_direct_get (struct pmi_direct *pd,
+                    const char *key,
+                    pmi_direct_get_f cb,
+                    void *arg)
+{
+    int rank = home_rank (pd, key);
+    struct get_request *req;
+    flux_future_t *f;
+
+    if (rank == pd->rank) {
+        cb (pd, json_string_value (json_object_get (pd->store, key)), arg);
+        return 0;
+    }
+    if (!(f = flux_shell_rpc_pack (pd->shell,
+                                   "pmi-get",
+                                   rank,
+                                   0,
+                                   "{s:s}",
+                                   "key", key)))
+        return -1;
+    if (!(req = calloc (1, sizeof (*req)))
+        || flux_future_aux_set (f, NULL, req, free) < 0) {
+        free (req);
+        goto error;
+    }
+    req->pd = pd;
+    req->cb = cb;
+    req->arg = arg;
+    if (flux_future_then (f, -1., get_continuation, req) < 0)
+        goto error;
+    return 0;
+error:
+    flux_future_destroy (f);
+    return -1;
+}
+
+struct pmi_direct *pmi_direct_create (flux_shell_t *shell)
+{
+    struct pmi_direct *pd;
+
+    if (!(pd = calloc (1, sizeof (*pd))))
+        return NULL;
+    pd->shell = shell;
+    pd->size = shell->info->shell_size;
+    pd->rank = shell->info->shell_rank;
+    if (!(pd->store = json_object ())) {
+        errno = ENOMEM;
+        goto error;
+    }
+    if (flux_shell_service_register (shell,
+                                     "pmi-put",
+                                     put_request_cb,
+                                     pd) < 0
+        || flux_shell_service_register (shell,
+                                        "pmi-get",
+                                        get_request_cb,
+                                        pd) < 0)
+        goto error;
+    return pd;
+error:
+    pmi_direct_destroy (pd);
+    return NULL;
+}
+
+void pmi_direct_destroy (struct pmi_direct *pd)
+{
+    if (pd) {
+        int saved_errno = errno;
+        flux_future_destroy (pd->put_f);
+        json_decref (pd->store);
+        free (pd);
+        errno = saved_errno;
+    }
+}
+
+/* vi: ts=4 sw=4 expandtab
+ */
@@ -0,0 +1,45 @@
+/************************************************************\
+ * Copyright 2026 Lawrence Livermore National Security, LLC
+ * (c.f. AUTHORS, NOTICE.LLNS, COPYING)
+ *
+ * This file is part of the Flux resource manager framework.
+ * For details, see https://github.com/flux-framework.
+ *
+ * SPDX-License-Identifier: LGPL-3.0
+\************************************************************/
+
+#ifndef SHELL_PMI_DIRECT_H
+#define SHELL_PMI_DIRECT_H
+
+/* Create handle for storing and fetching keys on their home shells.
+ */
+struct pmi_direct *pmi_direct_create (flux_shell_t *shell);
+void pmi_direct_destroy (struct pmi_direct *pd);
+
+typedef void (*pmi_direct_put_f)(struct pmi_direct *pd, int rc, void *arg);
+typedef void (*pmi_direct_get_f)(struct pmi_direct *pd,
+                                 const char *val,
+                                 void *arg);
+
+/* Store the string values of 'dict' on their home shells.
+ * Once all shells have acknowledged, 'cb' is invoked with rc=0 on success,
+ * or rc=-1 on failure.
+ */
+int pmi_direct_put (struct pmi_direct *pd,
+                    json_t *dict,
+                    pmi_direct_put_f cb,
+                    void *arg);
+
+/* Fetch 'key' from its home shell.  'cb' is invoked with the value,
+ * or NULL if the key is not found.  If this shell is the home shell,
+ * 'cb' is invoked before pmi_direct_get() returns.
+ */
+int pmi_direct_get (struct pmi_direct *pd,
+                    const char *key,
+                    pmi_direct_get_f cb,
+                    void *arg);
+
+#endif /* !SHELL_PMI_DIRECT_H */
+
+/* vi: ts=4 sw=4 expandtab
+ */
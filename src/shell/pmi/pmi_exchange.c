@@ -17,15 +17,32 @@
  * a callback.  Upon completion of the exchange, the callback is invoked.
  * The callback may access an updated json_t dictionary.
  *
- * A binary tree is computed across all shell ranks.
- * Gather aggregates hashes at each tree level, reducing the number
+ * By default, the exchange tree follows the broker tree based overlay
+ * network (TBON): the parent of a shell is the shell running on its
+ * broker's nearest TBON ancestor that is part of the job.  Thus each
+ * gather or broadcast message travels between overlay peers.  Shells
+ * with no such ancestor, e.g. all shells of a job that does not include
+ * the upper levels of the TBON, are arranged in a k-ary tree of the TBON
+ * degree rooted at shell 0, in shell rank order, so that shell 0 does
+ * not receive a message from each of them.  This requires a kary:K TBON topology, which the shell
+ * can compute locally from the tbon.topo broker attribute.
+ *
+ * If the TBON topology is not kary:K, or if a fanout is requested,
+ * a k-ary tree is computed across all shell ranks instead.
+ * N.B. This tree is created from thin air for algorithmic purposes.
+ * Nodes that are peers in the ersatz tree may actually be multiple hops
+ * apart on the Flux tree based overlay network at the broker level.
+ *
+ * Gather aggregates dicts at each tree level, reducing the number
  * of messages that have to be handled by shell 0.
  * Broadcast fans out at each tree level, reducing the number of messages
  * that have to be sent by rank 0.
  *
- * N.B. This binary tree is created from thin air for algorithmic purposes.
- * Nodes that are peers in the ersatz tree may actually be multiple hops
- * apart on the Flux tree based overlay network at the broker level.
+ * Dicts are exchanged as raw payloads of NUL-terminated key and value
+ * strings, "key\0value\0...".  Subtree payloads are merged by appending
+ * them to the session buffer, and the aggregate is forwarded verbatim,
+ * so shells decode only the final result.  If a key appears more than
+ * once, the last instance wins.
  */
 #define FLUX_SHELL_PLUGIN_NAME "pmi-simple"
 
@@ -33,6 +50,7 @@
 #include "config.h"
 #endif
 #include <stdlib.h>
+#include <string.h>
 #include <jansson.h>
 #include <flux/core.h>
 #include <flux/shell.h>
@@ -41,13 +59,17 @@
 
 #include "info.h"
 #include "internal.h"
+#include "svc.h"
 
 #include "pmi_exchange.h"
 
 #define DEFAULT_TREE_K 2
 
 struct session {
-    json_t *dict;               // container for gathered dictionary
+    char *buf;                  // gathered key/value strings
+    size_t len;
+    size_t size;
+    json_t *dict;               // decoded result of exchange
     pmi_exchange_f cb;          // callback for exchange completion
     void *cb_arg;
 
@@ -83,6 +105,7 @@ static void session_destroy (struct session *ses)
         }
         flux_future_destroy (ses->f);
         json_decref (ses->dict);
+        free (ses->buf);
         free (ses);
         errno = saved_errno;
     }
@@ -97,8 +120,6 @@ static struct session *session_create (struct pmi_exchange *pex)
     ses->pex = pex;
     if (!(ses->requests = zlist_new ()))
         goto nomem;
-    if (!(ses->dict = json_object ()))
-        goto nomem;
     return ses;
 nomem:
     errno = ENOMEM;
@@ -106,6 +127,94 @@ nomem:
     return NULL;
 }
 
+static int session_append (struct session *ses, const void *data, size_t len)
+{
+    if (ses->len + len > ses->size) {
+        size_t size = ses->size ? ses->size : 4096;
+        char *buf;
+
+        while (size < ses->len + len)
+            size *= 2;
+        if (!(buf = realloc (ses->buf, size))) {
+            errno = ENOMEM;
+            return -1;
+        }
+        ses->buf = buf;
+        ses->size = size;
+    }
+    if (len > 0)
+        memcpy (ses->buf + ses->len, data, len);
+    ses->len += len;
+    return 0;
+}
+
+/* Append the string values of 'dict' to the session buffer.
+ */
+static int session_append_dict (struct session *ses, json_t *dict)
+{
+    const char *key;
+    json_t *val;
+
+    json_object_foreach (dict, key, val) {
+        const char *s;
+
+        if (!(s = json_string_value (val))) {
+            errno = EINVAL;
+            return -1;
+        }
+        if (session_append (ses, key, strlen (key) + 1) < 0
+            || session_append (ses, s, strlen (s) + 1) < 0)
+            return -1;
+    }
+    return 0;
+}
+
+/* Ensure that 'data' is a well-formed sequence of key/value strings
+ * before it is merged into the session buffer.
+ */
+static int check_payload (const char *data, size_t len)
+{
+    int count = 0;
+
+    if (len > 0 && data[len - 1] != '\0') {
+        errno = EPROTO;
+        return -1;
+    }
+    for (size_t i = 0; i < len; i++) {
+        if (data[i] == '\0')
+            count++;
+    }
+    if (count % 2 != 0) {
+        errno = EPROTO;
+        return -1;
+    }
+    return 0;
+}
+
+/* Decode the final exchange result into ses->dict.
+ */
+static int session_decode (struct session *ses)
+{
+    size_t i = 0;
+
+    if (!(ses->dict = json_object ()))
+        goto nomem;
+    while (i < ses->len) {
+        const char *key = ses->buf + i;
+        const char *val = key + strlen (key) + 1;
+        json_t *o;
+
+        if (!(o = json_string (val))
+            || json_object_set_new (ses->dict, key, o) < 0)
+            goto nomem;
+        i = (val - ses->buf) + strlen (val) + 1;
+    }
+    return 0;
+nomem:
+    errno = ENOMEM;
+    return -1;
+}
+
 static void session_process (struct session *ses)
 {
     struct pmi_exchange *pex = ses->pex;
@@ -125,12 +234,12 @@ static void session_process (struct session *ses)
     if (pex->rank > 0 && !ses->f) {
         flux_future_t *f;
 
-        if (!(f = flux_shell_rpc_pack (pex->shell,
-                                       "pmi-exchange",
-                                       pex->parent_rank,
-                                       0,
-                                       "O",
-                                       ses->dict))
+        if (!(f = shell_svc_raw (pex->shell->svc,
+                                 "pmi-exchange",
+                                 pex->parent_rank,
+                                 0,
+                                 ses->buf,
+                                 ses->len))
                 || flux_future_then (f,
                                      -1,
                                      exchange_response_completion,
@@ -151,7 +260,7 @@ static void session_process (struct session *ses)
     /* Send exchange response(s), if needed.
      */
     while ((msg = zlist_pop (ses->requests))) {
-        if (flux_respond_pack (h, msg, "O", ses->dict) < 0) {
+        if (flux_respond_raw (h, msg, ses->buf, ses->len) < 0) {
             shell_warn ("error responding to pmi-exchange request");
             flux_msg_decref (msg);
             ses->has_error = 1;
@@ -159,6 +268,10 @@ static void session_process (struct session *ses)
         }
         flux_msg_decref (msg);
     }
+    if (session_decode (ses) < 0) {
+        shell_warn ("error decoding pmi-exchange result");
+        ses->has_error = 1;
+    }
 done:
     ses->cb (pex, ses->cb_arg);
     session_destroy (ses);
@@ -170,16 +283,23 @@ done:
 static void exchange_response_completion (flux_future_t *f, void *arg)
 {
     struct pmi_exchange *pex = arg;
-    json_t *dict;
+    struct session *ses = pex->session;
+    const void *data;
+    size_t len;
 
-    if (flux_rpc_get_unpack (f, "o", &dict) < 0) {
+    if (flux_rpc_get_raw (f, &data, &len) < 0) {
         shell_warn ("pmi-exchange request: %s", future_strerror (f, errno));
-        pex->session->has_error = 1;
+        ses->has_error = 1;
         goto done;
     }
-    if (json_object_update (pex->session->dict, dict) < 0) {
+    /* The response is the aggregate of all shells, including this
+     * subtree, so it replaces the gathered buffer.
+     */
+    ses->len = 0;
+    if (check_payload (data, len) < 0
+        || session_append (ses, data, len) < 0) {
         shell_warn ("pmi-exchange response handling failed to update dict");
-        pex->session->has_error = 1;
+        ses->has_error = 1;
         goto done;
     }
 done:
@@ -194,11 +314,16 @@ static void exchange_request_cb (flux_t *h,
                                  void *arg)
 {
     struct pmi_exchange *pex = arg;
-    json_t *dict;
+    const void *data;
+    size_t len;
     const char *errstr = NULL;
 
-    if (flux_request_unpack (msg, NULL, "o", &dict) < 0)
+    if (flux_request_decode_raw (msg, NULL, &data, &len) < 0)
+        goto error;
+    if (check_payload (data, len) < 0) {
+        errstr = "pmi-exchange request payload is malformed";
         goto error;
+    }
     if (!pex->session) {
         if (!(pex->session = session_create (pex)))
             goto error;
@@ -208,7 +333,7 @@ static void exchange_request_cb (flux_t *h,
         errno = EINPROGRESS;
         goto error;
     }
-    if (json_object_update (pex->session->dict, dict) < 0) {
+    if (session_append (pex->session, data, len) < 0) {
         errstr = "pmi-exchange request failed to update dict";
         goto nomem;
     }
@@ -246,10 +371,8 @@ int pmi_exchange (struct pmi_exchange *pex,
     pex->session->cb = cb;
     pex->session->cb_arg = arg;
     pex->session->local = 1;
-    if (json_object_update (pex->session->dict, dict) < 0) {
-        errno = ENOMEM;
+    if (session_append_dict (pex->session, dict) < 0)
         return -1;
-    }
     session_process (pex->session);
     return 0;
 }
@@ -269,12 +392,113 @@ static int child_count (int k, int rank, int size)
     return count;
 }
 
+/* Return K if the broker TBON topology is kary:K, otherwise -1.
+ */
+static int tbon_fanout (flux_shell_t *shell)
+{
+    return kary_parse_topo (flux_attr_get (shell->h, "tbon.topo"));
+}
+
+struct rankmap {
+    uint32_t rank;              // broker rank
+    int shell_rank;
+};
+
+static int rankmap_cmp (const void *a, const void *b)
+{
+    const struct rankmap *r1 = a;
+    const struct rankmap *r2 = b;
+
+    if (r1->rank < r2->rank)
+        return -1;
+    return r1->rank > r2->rank ? 1 : 0;
+}
+
+/* Return the shell rank of the nearest TBON ancestor of 'rank' in 'map',
+ * or -1 if no ancestor is part of the job.
+ */
+static int tbon_parentof (int k, struct rankmap *map, int size, uint32_t rank)
+{
+    while ((rank = kary_parentof (k, rank)) != KARY_NONE) {
+        struct rankmap key = { .rank = rank };
+        struct rankmap *entry;
+
+        if ((entry = bsearch (&key, map, size, sizeof (*map), rankmap_cmp)))
+            return entry->shell_rank;
+    }
+    return -1;
+}
+
+/* Helper for pmi_exchange_create() - derive the exchange tree from
+ * the broker TBON, a kary tree of degree 'k'.  Shell 0 is always the
+ * root.  Shells without a TBON ancestor in the job form a kary tree of
+ * degree 'k' under it, where orphans[0] is shell 0 and orphans[j] is
+ * the j-th orphaned shell.
+ */
+static int tbon_tree (struct pmi_exchange *pex, int k)
+{
+    struct rcalc_rankinfo ri;
+    struct rankmap *map;
+    uint32_t *ranks;
+    int *orphans;
+    int norphans = 1;
+    int rc = -1;
+
+    map = calloc (pex->size, sizeof (*map));
+    ranks = calloc (pex->size, sizeof (*ranks));
+    orphans = calloc (pex->size, sizeof (*orphans));
+    if (!map || !ranks || !orphans)
+        goto done;
+    for (int i = 0; i < pex->size; i++) {
+        if (rcalc_get_nth (pex->shell->info->rcalc, i, &ri) < 0)
+            goto done;
+        map[i].rank = ranks[i] = ri.rank;
+        map[i].shell_rank = i;
+    }
+    qsort (map, pex->size, sizeof (*map), rankmap_cmp);
+
+    pex->parent_rank = KARY_NONE;
+    pex->child_count = 0;
+    orphans[0] = 0;
+    for (int i = 1; i < pex->size; i++) {
+        int parent = tbon_parentof (k, map, pex->size, ranks[i]);
+
+        if (parent < 0) {
+            parent = orphans[kary_parentof (k, norphans)];
+            orphans[norphans++] = i;
+        }
+        if (i == pex->rank)
+            pex->parent_rank = parent;
+        if (parent == pex->rank)
+            pex->child_count++;
+    }
+    rc = 0;
+done:
+    free (map);
+    free (ranks);
+    free (orphans);
+    return rc;
+}
+
 struct pmi_exchange *pmi_exchange_create (flux_shell_t *shell, int k)
 {
     struct pmi_exchange *pex;
+    int tbon_k;
 
     if (!(pex = calloc (1, sizeof (*pex))))
         return NULL;
+    pex->shell = shell;
+    pex->size = shell->info->shell_size;
+    pex->rank = shell->info->shell_rank;
+
+    if (k <= 0 && (tbon_k = tbon_fanout (shell)) > 0) {
+        if (tbon_tree (pex, tbon_k) < 0)
+            goto error;
+        if (pex->rank == 0)
+            shell_debug ("using TBON-aligned exchange tree (kary:%d)",
+                         tbon_k);
+        goto done;
+    }
     if (k <= 0)
         k = DEFAULT_TREE_K;
     else if (k > shell->info->shell_size) {
@@ -286,12 +510,10 @@ struct pmi_exchange *pmi_exchange_create (flux_shell_t *shell, int k)
         if (shell->info->shell_rank == 0)
             shell_warn ("using k=%d", k);
     }
-    pex->shell = shell;
-    pex->size = shell->info->shell_size;
-    pex->rank = shell->info->shell_rank;
     pex->parent_rank = kary_parentof (k, pex->rank);
     pex->child_count = child_count (k, pex->rank, pex->size);
-
+done:
+    shell_debug ("exchange tree: %d children", pex->child_count);
     if (flux_shell_service_register (shell,
                                      "pmi-exchange",
                                      exchange_request_cb,
@@ -20,6 +20,7 @@
 #include <fcntl.h>
 #include <stdarg.h>
 #include <locale.h>
+#include <stdbool.h>
 #include <jansson.h>
 #include <flux/core.h>
 #include <flux/shell.h>
@@ -33,6 +34,8 @@
 #include "src/common/libutil/fdutils.h"
 #include "src/common/libutil/basename.h"
 #include "src/common/libutil/jpath.h"
+#include "src/common/libutil/monotime.h"
+#include "src/common/libutil/iterators.h"
 #include "src/common/libjob/idf58.h"
 #include "src/common/libtaskmap/taskmap_private.h"
 #include "ccan/str/str.h"
@@ -1871,54 +1874,159 @@ static int shell_create_tasks (flux_shell_t *shell)
     return 0;
 }
 
-static int shell_start_tasks (flux_shell_t *shell)
+/*  Per-phase elapsed time of local task launch, in seconds, reported in
+ *  the shell.start event context by the leader shell.
+ */
+struct launch_timing {
+    double init;        // task.init callbacks
+    double render;      // mustache rendering of command args
+    double fork;        // shell_task_start()
+    double forked;      // task.fork callbacks
+    double total;
+};
+
+static void shell_task_launch_init (flux_shell_t *shell,
+                                    flux_shell_task_t *task,
+                                    struct launch_timing *t)
 {
-    flux_shell_task_t *task;
+    struct timespec ts;
 
-    task = zlist_first (shell->tasks);
-    while (task) {
-        shell->current_task = task;
+    /*  Call all plugin task_init callbacks:
+     */
+    monotime (&ts);
+    if (shell_task_init (shell) < 0)
+        shell_die (1, "failed to initialize taskid=%d", task->rank);
+    t->init += monotime_since (ts) / 1000.;
 
-        /*  Call all plugin task_init callbacks:
-         */
-        if (shell_task_init (shell) < 0)
-            shell_die (1, "failed to initialize taskid=%d", task->rank);
+    /*  Render any mustache templates in command args
+     */
+    monotime (&ts);
+    if (frob_command (shell, task->cmd))
+        shell_die (1, "failed rendering of mustachioed command args");
+    t->render += monotime_since (ts) / 1000.;
+}
+
+static void shell_task_launch_fork (flux_shell_t *shell,
+                                    flux_shell_task_t *task,
+                                    struct launch_timing *t)
+{
+    struct timespec ts;
 
-        /*  Render any mustache templates in command args
+    monotime (&ts);
+    if (shell_task_start (shell, task, task_completion_cb, shell) < 0) {
+        int ec = 1;
+        /* bash standard, 126 for permission/access denied, 127
+         * for command not found.  Note that shell only launches
+         * local tasks, therefore no need to check for
+         * EHOSTUNREACH.
          */
-        if (frob_command (shell, task->cmd))
-            shell_die (1, "failed rendering of mustachioed command args");
-
-        if (shell_task_start (shell, task, task_completion_cb, shell) < 0) {
-            int ec = 1;
-            /* bash standard, 126 for permission/access denied, 127
-             * for command not found.  Note that shell only launches
-             * local tasks, therefore no need to check for
-             * EHOSTUNREACH.
-             */
-            if (errno == EPERM || errno == EACCES)
-                ec = 126;
-            else if (errno == ENOENT)
-                ec = 127;
-            shell_die (ec,
-                       "task %d (host %s): start failed: %s: %s",
-                       task->rank,
-                       shell->hostname,
-                       flux_cmd_arg (task->cmd, 0),
-                       strerror (errno));
-        }
+        if (errno == EPERM || errno == EACCES)
+            ec = 126;
+        else if (errno == ENOENT)
+            ec = 127;
+        shell_die (ec,
+                   "task %d (host %s): start failed: %s: %s",
+                   task->rank,
+                   shell->hostname,
+                   flux_cmd_arg (task->cmd, 0),
+                   strerror (errno));
+    }
+    t->fork += monotime_since (ts) / 1000.;
 
-        if (flux_shell_add_completion_ref (shell, "task%d", task->rank) < 0)
-            shell_die (1, "flux_shell_add_completion_ref");
+    if (flux_shell_add_completion_ref (shell, "task%d", task->rank) < 0)
+        shell_die (1, "flux_shell_add_completion_ref");
+}
 
-        /*  Call all plugin task_fork callbacks:
-         */
-        if (shell_task_forked (shell) < 0)
-            shell_die (1, "shell_task_forked");
+static void shell_task_launch_forked (flux_shell_t *shell,
+                                      flux_shell_task_t *task,
+                                      struct launch_timing *t)
+{
+    struct timespec ts;
 
-        task = zlist_next (shell->tasks);
+    /*  Call all plugin task_fork callbacks:
+     */
+    monotime (&ts);
+    if (shell_task_forked (shell) < 0)
+        shell_die (1, "shell_task_forked");
+    t->forked += monotime_since (ts) / 1000.;
+}
+
+/*  Return true if the task-launch shell option requests that tasks be
+ *  launched in phases, i.e. task.init is called for all local tasks,
+ *  then all tasks are forked, then task.fork is called for all tasks.
+ */
+static bool shell_task_launch_phased (flux_shell_t *shell)
+{
+    const char *mode = "serial";
+
+    if (flux_shell_getopt_unpack (shell, "task-launch", "s", &mode) < 0)
+        shell_die (1, "task-launch shell option must be a string");
+    if (streq (mode, "phased"))
+        return true;
+    if (!streq (mode, "serial"))
+        shell_die (1, "invalid task-launch shell option '%s'", mode);
+    return false;
+}
+
+static int shell_start_tasks (flux_shell_t *shell)
+{
+    flux_shell_task_t *task;
+    struct launch_timing t = { 0 };
+    struct timespec ts;
+
+    monotime (&ts);
+    if (shell_task_launch_phased (shell)) {
+        /*  Run each phase across all local tasks before the next, so
+         *  the per-task work of plugins is done before the first fork
+         *  and tasks are forked back to back.  shell->current_task is
+         *  set for each callback, so plugins see the same task context
+         *  as in serial launch.
+         */
+        FOREACH_ZLIST (shell->tasks, task) {
+            shell->current_task = task;
+            shell_task_launch_init (shell, task, &t);
+        }
+        FOREACH_ZLIST (shell->tasks, task) {
+            shell->current_task = task;
+            shell_task_launch_fork (shell, task, &t);
+        }
+        FOREACH_ZLIST (shell->tasks, task) {
+            shell->current_task = task;
+            shell_task_launch_forked (shell, task, &t);
+        }
+    }
+    else {
+        FOREACH_ZLIST (shell->tasks, task) {
+            shell->current_task = task;
+            shell_task_launch_init (shell, task, &t);
+            shell_task_launch_fork (shell, task, &t);
+            shell_task_launch_forked (shell, task, &t);
+        }
     }
     shell->current_task = NULL;
+    t.total = monotime_since (ts) / 1000.;
+
+    shell_debug ("started %zu tasks in %.3fs "
+                 "(init=%.3fs render=%.3fs fork=%.3fs forked=%.3fs)",
+                 zlist_size (shell->tasks),
+                 t.total,
+                 t.init,
+                 t.render,
+                 t.fork,
+                 t.forked);
+
+    if (shell->info->shell_rank == 0
+        && flux_shell_add_event_context (shell,
+                                         "shell.start",
+                                         0,
+                                         "{s:{s:f s:f s:f s:f s:f}}",
+                                         "timing",
+                                         "init", t.init,
+                                         "render", t.render,
+                                         "fork", t.fork,
+                                         "forked", t.forked,
+                                         "total", t.total) < 0)
+        shell_log_errno ("failed to add timing to shell.start context");
     return 0;
 }
 
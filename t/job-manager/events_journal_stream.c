@@ -36,6 +36,35 @@ void cancel_cb (int sig)
     flux_future_destroy (f2);
 }
 
+void print_events (json_t *o)
+{
+    flux_jobid_t id;
+    json_t *events;
+    size_t index;
+    json_t *entry;
+
+    if (json_unpack (o, "{s:I s:o}", "id", &id, "events", &events) < 0)
+        log_msg_exit ("job-manager.events-journal: malformed response");
+    json_array_foreach (events, index, entry) {
+        /* For testing, wrap each eventlog entry in an outer object that
+         * includes the jobid.  Not coincidentally, this looks like
+         * the old format for job manager journal entries.
+         */
+        json_t *envelope;
+        char *s;
+
+        if (!(envelope = json_pack ("{s:I s:O}",
+                                    "id", id,
+                                    "entry", entry))
+            || !(s = json_dumps (envelope, 0)))
+            log_msg_exit ("Error creating eventlog envelope");
+        printf ("%s\n", s);
+        fflush (stdout);
+        free (s);
+        json_decref (envelope);
+    }
+}
+
 int main (int argc, char *argv[])
 {
     ssize_t inlen;
@@ -66,37 +95,25 @@ int main (int argc, char *argv[])
         log_err_exit ("signal");
 
     while (1) {
-        flux_jobid_t id;
-        json_t *events;
+        json_t *o;
+        json_t *batch = NULL;
         size_t index;
-        json_t *entry;
-        if (flux_rpc_get_unpack (f,
-                                 "{s:I s:o}",
-                                 "id", &id,
-                                 "events", &events) < 0) {
+        json_t *value;
+
+        if (flux_rpc_get_unpack (f, "o", &o) < 0) {
             if (errno == ENODATA)
                 break;
             log_msg_exit ("job-manager.events-journal: %s",
                           future_strerror (f, errno));
         }
-        json_array_foreach (events, index, entry) {
-            /* For testing, wrap each eventlog entry in an outer object that
-             * includes the jobid.  Not coincidentally, this looks like
-             * the old format for job manager journal entries.
-             */
-            json_t *o;
-            char *s;
-
-            if (!(o = json_pack ("{s:I s:O}",
-                                 "id", id,
-                                 "entry", entry))
-                || !(s = json_dumps (o, 0)))
-                log_msg_exit ("Error creating eventlog envelope");
-            printf ("%s\n", s);
-            fflush (stdout);
-            free (s);
-            json_decref (o);
+        if (json_unpack (o, "{s?o}", "batch", &batch) < 0)
+            log_msg_exit ("job-manager.events-journal: malformed response");
+        if (batch) {
+            json_array_foreach (batch, index, value)
+                print_events (value);
         }
+        else
+            print_events (o);
         flux_future_reset (f);
     }
     flux_future_destroy (f);
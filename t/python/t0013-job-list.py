@@ -332,6 +332,28 @@ class TestJob(unittest.TestCase):
         ).get_jobinfos():
             self.assertEqual(job.name, "sleep")
 
+    # streaming job list returns the same jobs, in order, in chunks
+    def test_21_list_streaming(self):
+        expected = [job["id"] for job in self.getJobs(flux.job.job_list(self.fh))]
+        rpc_handle = flux.job.job_list(self.fh, chunk_size=3)
+        chunks = list(rpc_handle._chunks())
+        self.assertEqual(len(chunks), (len(expected) + 2) // 3)
+        for jobs in chunks:
+            self.assertLessEqual(len(jobs), 3)
+        self.assertEqual([job["id"] for chunk in chunks for job in chunk], expected)
+
+    # streaming job list respects max_entries
+    def test_22_list_streaming_max_entries(self):
+        rpc_handle = flux.job.job_list(self.fh, 5, chunk_size=2)
+        self.assertEqual(len(self.getJobs(rpc_handle)), 5)
+
+    # streaming JobList.jobs() returns JobInfo objects
+    def test_23_joblist_streaming(self):
+        expected = self.getJobs(flux.job.job_list(self.fh))
+        jobs = flux.job.JobList(self.fh, chunk_size=4).jobs()
+        self.assertEqual([job.id for job in jobs], [job["id"] for job in expected])
+        self.assertTrue(all(isinstance(job, flux.job.JobInfo) for job in jobs))
+
 
 if __name__ == "__main__":
     from subflux import rerun_under_flux
@@ -110,6 +110,46 @@ test_expect_success 'job-ingest: job announced to job manager' '
 	grep -q "userid=$(id -u)" jobman.out
 '
 
+test_expect_success 'job-ingest: job submitted on rank 3 is relayed upstream' '
+	jobid=$(flux exec -r 3 flux job submit basic.json | flux job id) &&
+	flux kvs eventlog get ${DUMMY_EVENTLOG} | grep "id=${jobid}" &&
+	flux kvs get --json $(flux job id --to=kvs ${jobid}).jobspec \
+		>jobspec3.out &&
+	flux exec -r 3 flux module stats job-ingest >stats3.out &&
+	flux module stats job-ingest >stats0.out &&
+	jq -e ".relay.enabled == true" <stats3.out &&
+	jq -e ".relay.enabled == false" <stats0.out &&
+	jq -e ".relay.requests >= 1" <stats0.out
+'
+
+test_expect_success 'job-ingest: relay can be disabled with no-relay' '
+	ingest_module reload \
+		validator-plugins=jobspec \
+		validator-args=--require-version=any \
+		no-relay &&
+	jobid=$(flux exec -r 3 flux job submit basic.json | flux job id) &&
+	flux kvs eventlog get ${DUMMY_EVENTLOG} | grep "id=${jobid}" &&
+	flux exec -r 3 flux module stats job-ingest >stats3b.out &&
+	jq -e ".relay.enabled == false" <stats3b.out
+'
+
+test_expect_success 'job-ingest: relay falls back to local commit if upstream is not loaded' '
+	ingest_module reload \
+		validator-plugins=jobspec \
+		validator-args=--require-version=any &&
+	flux module remove job-ingest &&
+	jobid=$(flux exec -r 1 flux job submit basic.json | flux job id) &&
+	flux kvs eventlog get ${DUMMY_EVENTLOG} | grep "id=${jobid}" &&
+	flux exec -r 1 flux module stats job-ingest >stats1.out &&
+	jq -e ".relay.enabled == false" <stats1.out &&
+	flux module load job-ingest \
+		validator-plugins=jobspec \
+		validator-args=--require-version=any &&
+	ingest_module reload \
+		validator-plugins=jobspec \
+		validator-args=--require-version=any
+'
+
 test_expect_success 'job-ingest: instance owner can submit urgency=31' '
 	flux job submit --urgency=31 basic.json
 '
@@ -164,6 +204,10 @@ test_expect_success 'job-ingest: handle total batch failure in job-ingest' '
 	test_must_fail flux submit --cc=1-4 hostname
 '
 
+test_expect_success 'job-ingest: total batch failure is relayed downstream' '
+	test_must_fail flux exec -r 3 flux submit --cc=1-4 hostname
+'
+
 test_expect_success 'flux module stats job-ingest is open to guests' '
 	FLUX_HANDLE_ROLEMASK=0x2 \
 	    flux module stats job-ingest >/dev/null
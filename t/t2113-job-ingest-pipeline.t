@@ -15,10 +15,28 @@ test_expect_success 'no workers are running at the start' '
 test_expect_success 'run a job with no ingest configuration' '
 	flux run true
 '
-test_expect_success 'one validator, no frobnicator started' '
+test_expect_success 'job was validated in-process, no workers started' '
 	flux module stats job-ingest >stats2.out &&
 	jq -e ".pipeline.frobnicator.running == 0" <stats2.out &&
-	jq -e ".pipeline.validator.running == 1" <stats2.out
+	jq -e ".pipeline.validator.running == 0" <stats2.out &&
+	jq -e ".pipeline.native_validator.enabled == true" <stats2.out &&
+	jq -e ".pipeline.native_validator.requests == 1" <stats2.out
+'
+test_expect_success 'batch statistics reflect the committed job' '
+	jq -e ".batch.inflight == 0" <stats2.out &&
+	jq -e ".batch.window == 0" <stats2.out &&
+	jq -e ".batch.limit >= 64" <stats2.out &&
+	jq -e ".batch.commit_latency > 0" <stats2.out &&
+	jq -e "[.batch.size[]] | add == 1" <stats2.out &&
+	jq -e "[.batch.latency[]] | add == 1" <stats2.out
+'
+test_expect_success 'invalid jobspec is rejected by in-process validator' '
+	flux run --dry-run true | jq -c ".version = 2" >bad.json &&
+	test_must_fail flux job submit bad.json 2>bad.err &&
+	test_debug "cat bad.err" &&
+	grep "version must be 1" bad.err &&
+	flux module stats job-ingest >stats2b.out &&
+	jq -e ".pipeline.native_validator.errors == 1" <stats2b.out
 '
 test_expect_success 'configure frobnicator' '
 	flux config load <<-EOT
@@ -31,10 +49,11 @@ test_expect_success 'configure frobnicator' '
 test_expect_success 'run a job with unspecified duration' '
 	flux submit true >jobid1
 '
-test_expect_success 'one validator, one frobnicator started' '
+test_expect_success 'one frobnicator started, job validated in-process' '
 	flux module stats job-ingest >stats3.out &&
 	jq -e ".pipeline.frobnicator.running == 1" <stats3.out &&
-	jq -e ".pipeline.validator.running == 1" <stats3.out
+	jq -e ".pipeline.validator.running == 0" <stats3.out &&
+	jq -e ".pipeline.native_validator.requests == 3" <stats3.out
 '
 test_expect_success 'job duration was assigned from default' '
 	flux job info $(cat jobid1) jobspec >jobspec1 &&
@@ -43,7 +62,6 @@ test_expect_success 'job duration was assigned from default' '
 test_expect_success 'force module config update' '
 	flux module stats job-ingest >stats4.out &&
 	jq -r ".pipeline.frobnicator.pids[0]" <stats4.out >frob.pid &&
-	jq -r ".pipeline.validator.pids[0]" <stats4.out >val.pid &&
 	flux config get | flux config load
 '
 test_expect_success 'run a job to trigger work crew with new config' '
@@ -52,19 +70,17 @@ test_expect_success 'run a job to trigger work crew with new config' '
 test_expect_success 'workers were restarted' '
 	flux module stats job-ingest >stats5.out &&
 	jq -r ".pipeline.frobnicator.pids[0]" <stats5.out >frob2.pid &&
-	jq -r ".pipeline.validator.pids[0]" <stats5.out >val2.pid &&
-	test_must_fail test_cmp frob.pid frob2.pid &&
-	test_must_fail test_cmp val.pid val2.pid
+	test_must_fail test_cmp frob.pid frob2.pid
 '
 test_expect_success 'run a job with novalidate flag' '
 	jq -r ".pipeline.frobnicator.requests" <stats5.out >frob.count &&
-	jq -r ".pipeline.validator.requests" <stats5.out >val.count &&
+	jq -r ".pipeline.native_validator.requests" <stats5.out >val.count &&
 	flux run --flags novalidate true
 '
 test_expect_success 'job was frobbed but not validated' '
 	flux module stats job-ingest >stats6.out &&
 	jq -r ".pipeline.frobnicator.requests" <stats6.out >frob2.count &&
-	jq -r ".pipeline.validator.requests" <stats6.out >val2.count &&
+	jq -r ".pipeline.native_validator.requests" <stats6.out >val2.count &&
 	test_must_fail test_cmp frob.count frob2.count &&
 	test_cmp val.count val2.count
 '
@@ -77,7 +93,7 @@ test_expect_success 'run a job with novalidate flag' '
 test_expect_success 'job was neither frobbed nor validated' '
 	flux module stats job-ingest >stats7.out &&
 	jq -r ".pipeline.frobnicator.requests" <stats7.out >frob3.count &&
-	jq -r ".pipeline.validator.requests" <stats7.out >val3.count &&
+	jq -r ".pipeline.native_validator.requests" <stats7.out >val3.count &&
 	test_cmp frob2.count frob3.count &&
 	test_cmp val2.count val3.count
 '
@@ -87,12 +103,26 @@ test_expect_success 'run a job' '
 test_expect_success 'job was validated but not frobbed' '
 	flux module stats job-ingest >stats8.out &&
 	jq -r ".pipeline.frobnicator.requests" <stats8.out >frob4.count &&
-	jq -r ".pipeline.validator.requests" <stats8.out >val4.count &&
+	jq -r ".pipeline.native_validator.requests" <stats8.out >val4.count &&
 	test_cmp frob3.count frob4.count &&
 	test_must_fail test_cmp val3.count val4.count
 '
+test_expect_success 'configure jobspec validator plugin explicitly' '
+	flux config load <<-EOT
+	[ingest.validator]
+	plugins = [ "jobspec" ]
+	EOT
+'
+test_expect_success 'run a job' '
+	flux run true
+'
+test_expect_success 'job was validated by validator worker' '
+	flux module stats job-ingest >stats9.out &&
+	jq -e ".pipeline.native_validator.enabled == false" <stats9.out &&
+	jq -e ".pipeline.validator.running == 1" <stats9.out
+'
 test_expect_success 'stop validator 0' '
-	valpid=$(jq -r ".pipeline.validator.pids[0]" <stats8.out) &&
+	valpid=$(jq -r ".pipeline.validator.pids[0]" <stats9.out) &&
 	kill -STOP $valpid
 '
 test_expect_success 'remove job-ingest to trigger cleanup' '
@@ -227,6 +227,49 @@ test_expect_success NO_CHAIN_LINT 'job-manager: events-journal contains older jo
 	wait $pid
 '
 
+test_expect_success NO_CHAIN_LINT 'job-manager: events-journal batch shows all events' '
+	jq -j -c -n "{batch:true}" \
+		| $EVENTS_JOURNAL_STREAM > events8.out &
+	pid=$! &&
+	jobid=`flux job submit basic.json | flux job id` &&
+	wait_event_name ${jobid} clean events8.out &&
+	check_event_name ${jobid} submit events8.out &&
+	check_event_name ${jobid} depend events8.out &&
+	check_event_name ${jobid} alloc events8.out &&
+	check_event_name ${jobid} start events8.out &&
+	check_event_name ${jobid} finish events8.out &&
+	check_event_name ${jobid} release events8.out &&
+	check_event_name ${jobid} free events8.out &&
+	check_event_name ${jobid} clean events8.out &&
+	kill -s USR1 $pid &&
+	wait $pid
+'
+
+test_expect_success NO_CHAIN_LINT 'job-manager: events-journal batch w/ allow works' '
+	jq -j -c -n "{batch:true, allow:{depend:1, clean:1}}" \
+		| $EVENTS_JOURNAL_STREAM > events9.out &
+	pid=$! &&
+	jobid=`flux job submit basic.json | flux job id` &&
+	wait_event_name ${jobid} clean events9.out &&
+	test_must_fail check_event_name ${jobid} submit events9.out &&
+	check_event_name ${jobid} depend events9.out &&
+	test_must_fail check_event_name ${jobid} alloc events9.out &&
+	test_must_fail check_event_name ${jobid} start events9.out &&
+	test_must_fail check_event_name ${jobid} finish events9.out &&
+	test_must_fail check_event_name ${jobid} release events9.out &&
+	test_must_fail check_event_name ${jobid} free events9.out &&
+	check_event_name ${jobid} clean events9.out &&
+	kill -s USR1 $pid &&
+	wait $pid
+'
+
+test_expect_success 'job-manager: events-journal batch stats are reported' '
+	flux module stats job-manager >stats.out &&
+	jq -e ".journal.batch.count > 0" <stats.out &&
+	jq -e ".journal.batch.max > 0" <stats.out &&
+	jq -e ".journal.batch.pending == 0" <stats.out
+'
+
 test_expect_success 'job-manager: events-journal request fails with EPROTO on empty payload' '
 	$RPC job-manager.events-journal 71 < /dev/null
 '
@@ -2773,6 +2773,12 @@ test_expect_success 'job-stats correct after purge' '
 	echo $debugq | jq -e ".inactive_purged == 1"
 '
 
+test_expect_success 'queue and userid queries reflect purged jobs' '
+	test $(flux jobs -n -a --queue=batch | wc -l) -eq 1 &&
+	test $(flux jobs -n -a --queue=debug | wc -l) -eq 1 &&
+	test $(flux jobs -n -a -u $(id -u) | wc -l) -eq 2
+'
+
 test_expect_success 'remove queues' '
 	flux config load < /dev/null
 '
@@ -2793,6 +2799,15 @@ test_expect_success 'list request with invalid input fails with EPROTO(71) (attr
 	EOF
 	test_cmp ${name}.expected ${name}.out
 '
+test_expect_success 'list request with invalid input fails with EPROTO(71) (chunk_size <= 0)' '
+	name="chunk-size-zero" &&
+	jq -j -c -n  "{max_entries:5, attrs:[], chunk_size:0}" \
+	  | $listRPC >${name}.out &&
+	cat <<-EOF >${name}.expected &&
+	errno 71: invalid payload: chunk_size <= 0 not allowed
+	EOF
+	test_cmp ${name}.expected ${name}.out
+'
 test_expect_success 'list request with invalid input fails with EINVAL(22) (attrs non-string)' '
 	name="attr-not-string" &&
 	jq -j -c -n  "{max_entries:5, attrs:[5]}" \
@@ -2848,8 +2863,12 @@ test_expect_success 'list-id request with invalid input fails with EINVAL(22) (a
 # directly from the KVS at startup, but now it gets them via the job manager
 # journal.  Therefore we need to restart the job-manager too, which requires
 # some other things to be restarted to get a functional system.
+#
+# Drop the job-list checkpoint, since inactive jobs saved there would
+# otherwise take precedence over eventlogs modified in the KVS.
 restart_from_kvs() {
 	flux module remove job-list
+	flux kvs unlink -f checkpoint.job-list
 	flux module reload job-manager
 	flux module reload -f sched-simple
 	flux module reload -f job-exec
@@ -3014,6 +3033,69 @@ test_expect_success 'flux job list works on racy annotations' '
 	cat list_racy_annotation.out | jq -e ".annotations"
 '
 
+#
+# job-list checkpoint
+#
+
+wait_checkpoint() {
+	id=$(flux job id --to=dec $1)
+	local i=0
+	while ! flux kvs get --raw checkpoint.job-list \
+		   | jq -e "select(.context.id == ${id})" >/dev/null \
+		   && [ $i -lt 50 ]
+	do
+		sleep 0.1
+		i=$((i + 1))
+	done
+	if [ "$i" -eq "50" ]
+	then
+		return 1
+	fi
+	return 0
+}
+
+test_expect_success 'job-list appends jobs to checkpoint as they become inactive' '
+	jobid=$(flux submit --wait hostname | flux job id) &&
+	wait_checkpoint $jobid
+'
+test_expect_success 'job-list saves inactive jobs to checkpoint on unload' '
+	flux jobs -a -n --filter=inactive \
+		-o "{id} {result} {queue} {nodelist} {t_inactive}" \
+		| sort >checkpoint.pre &&
+	flux module remove job-list &&
+	test $(flux kvs get --raw checkpoint.job-list | wc -l) \
+		-eq $(wc -l <checkpoint.pre)
+'
+test_expect_success 'job-list restores inactive jobs from checkpoint' '
+	flux module load job-list &&
+	flux jobs -a -n --filter=inactive \
+		-o "{id} {result} {queue} {nodelist} {t_inactive}" \
+		| sort >checkpoint.post &&
+	test_cmp checkpoint.pre checkpoint.post
+'
+test_expect_success 'jobs inactive after checkpoint are loaded from journal' '
+	flux module remove job-list &&
+	jobid=$(flux submit --wait hostname | flux job id) &&
+	flux module load job-list &&
+	flux job list-ids $jobid | jq -e ".state == 64"
+'
+test_expect_success 'inactive jobs missing from checkpoint are loaded from journal' '
+	jobid=$(flux submit --wait hostname | flux job id) &&
+	id=$(flux job id --to=dec $jobid) &&
+	flux module remove job-list &&
+	flux kvs get --raw checkpoint.job-list \
+		| jq -c "select(.context.id != ${id})" >checkpoint.missing &&
+	flux kvs put --raw checkpoint.job-list=- <checkpoint.missing &&
+	flux module load job-list &&
+	flux job list-ids $jobid | jq -e ".state == 64"
+'
+test_expect_success 'jobs purged while job-list is unloaded are not restored' '
+	flux module remove job-list &&
+	flux job purge --force --num-limit=1 &&
+	flux module load job-list &&
+	test $(flux jobs -a -n --filter=inactive | wc -l) -eq 1
+'
+
 test_expect_success 'flux job list subcommands are not displayed in help' '
 	test_must_fail flux job -h 2>job-help.err &&
 	test_must_fail grep "^[ ]*list" job-help.err
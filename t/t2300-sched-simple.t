@@ -251,6 +251,16 @@ test_expect_success 'sched-simple: submit job and cancel it' '
 	flux cancel $(cat job19.id) &&
 	$dmesg_grep -t 10 "free: rank0/core0"
 '
+test_expect_success 'sched-simple: reload sched-simple without batched free' '
+	flux module reload sched-simple test-free-nobatch
+'
+test_expect_success 'sched-simple: submit job and cancel it' '
+	flux dmesg --clear &&
+	flux job submit basic.json >job20.id &&
+	flux job wait-event --timeout=5.0 $(cat job20.id) alloc &&
+	flux cancel $(cat job20.id) &&
+	$dmesg_grep -t 10 "free: rank0/core0"
+'
 test_expect_success 'sched-simple: remove sched-simple and cancel jobs' '
 	flux module remove sched-simple &&
 	flux cancel --all
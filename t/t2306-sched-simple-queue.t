@@ -0,0 +1,56 @@
+#!/bin/sh
+
+test_description='test sched-simple with a large pending queue
+'
+
+# Append --logfile option if FLUX_TESTS_LOGFILE is set in environment:
+test -n "$FLUX_TESTS_LOGFILE" && set -- "$@" --logfile
+. $(dirname $0)/sharness.sh
+
+test_under_flux 1
+
+# Number of pending jobs to queue in sched-simple. Set higher,
+# e.g. SCHED_QUEUE_NJOBS=100000, to use this test as a benchmark.
+NJOBS=${SCHED_QUEUE_NJOBS:-1000}
+
+# Usage: wait_alloc_pending COUNT
+# Wait up to 120s for COUNT alloc requests pending to scheduler
+wait_alloc_pending () {
+	i=0
+	while ! flux queue status -v \
+	    | grep -q "^$1 alloc requests pending to scheduler"; do
+		sleep 0.1
+		i=$((i+1))
+		test $i -lt 1200 || return 1
+	done
+}
+
+test_expect_success 'reload sched-simple in unlimited mode' '
+	flux module reload sched-simple mode=unlimited
+'
+test_expect_success 'occupy all resources with an exclusive job' '
+	flux submit -N1 --exclusive --wait-event=start sleep inf >blocker.id
+'
+test_expect_success "submit $NJOBS jobs that remain pending" '
+	flux submit --cc=1-$NJOBS -n1 true >pending.ids &&
+	test $(wc -l <pending.ids) -eq $NJOBS
+'
+test_expect_success 'all jobs reach the scheduler queue' '
+	wait_alloc_pending $NJOBS
+'
+test_expect_success 'expedite the last pending job' '
+	run_timeout 30 flux job urgency $(tail -n 1 pending.ids) expedite
+'
+test_expect_success 'cancel all but the last pending job' '
+	head -n $((NJOBS-1)) pending.ids >cancel.ids &&
+	run_timeout 120 flux cancel $(cat cancel.ids) &&
+	wait_alloc_pending 1
+'
+test_expect_success 'the expedited job runs once resources are freed' '
+	flux cancel $(cat blocker.id) &&
+	run_timeout 30 flux job wait-event $(tail -n 1 pending.ids) clean
+'
+test_expect_success 'no alloc requests remain pending' '
+	wait_alloc_pending 0
+'
+test_done
@@ -0,0 +1,46 @@
+#!/bin/sh
+
+test_description='Test resource module hwloc topology cache'
+
+# Append --logfile option if FLUX_TESTS_LOGFILE is set in environment:
+test -n "$FLUX_TESTS_LOGFILE" && set -- "$@" --logfile
+. `dirname $0`/sharness.sh
+
+test_expect_success 'create config with resource.topo-cache' '
+	mkdir cache &&
+	cat <<-EOF >cache.toml
+	[resource]
+	topo-cache = "$(pwd)/cache"
+	EOF
+'
+test_expect_success 'topology is discovered and cached on first start' '
+	flux start --conf=cache.toml \
+		flux resource list -no {ncores} >ncores.out &&
+	test_debug "ls -l cache" &&
+	test $(ls cache/*.json | wc -l) -eq 1 &&
+	jq -e ".signature and .xml" cache/*.json
+'
+test_expect_success 'cached topology is used on restart' '
+	flux start --conf=cache.toml \
+		sh -c "flux dmesg | grep \"loaded hwloc XML from\" \
+		    && flux resource list -no {ncores}" >ncores2.out &&
+	test_debug "cat ncores2.out" &&
+	tail -n 1 ncores2.out >ncores2.count &&
+	test_cmp ncores.out ncores2.count
+'
+test_expect_success 'changed hardware signature forces rediscovery' '
+	file=$(ls cache/*.json) &&
+	jq ".signature = \"invalid\"" $file >tmp.json &&
+	mv tmp.json $file &&
+	flux start --conf=cache.toml \
+		sh -c "flux dmesg | grep \"hardware signature changed\"" &&
+	jq -e ".signature != \"invalid\"" $file
+'
+test_expect_success 'invalid cache entry is ignored' '
+	file=$(ls cache/*.json) &&
+	echo "{}" >$file &&
+	flux start --conf=cache.toml \
+		flux resource list -no {ncores} >ncores3.out &&
+	test_cmp ncores.out ncores3.out
+'
+test_done
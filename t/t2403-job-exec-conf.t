@@ -357,4 +357,25 @@ test_expect_success 'job-exec: bad sdexec properties leads to error on via confi
 	grep "exec.sdexec-properties.MemoryHigh is not a string" reload9B.err &&
 	rm -f ${FLUX_CONF_DIR}/exec.toml
 '
+test_expect_success 'job-exec: max-start-per-loop can be set in exec conf' '
+	name=mplconf &&
+	cat <<-EOF > ${name}.toml &&
+	[exec]
+	max-start-per-loop = 32
+	EOF
+	flux start --config-path=${name}.toml -s2 \
+		"flux module stats -p bulk-exec.config.max_start_per_loop job-exec \
+		 && flux run -N2 true" > ${name}.out 2>&1 &&
+	grep "^32$" ${name}.out
+'
+test_expect_success 'job-exec: bad max-start-per-loop config causes module failure' '
+	name=bad-mplconf &&
+	cat <<-EOF > ${name}.toml &&
+	[exec]
+	max-start-per-loop = 0
+	EOF
+	test_must_fail flux start --config-path=${name}.toml -s1 \
+		flux dmesg > ${name}.log 2>&1 &&
+	grep "exec.max-start-per-loop must be >= 1" ${name}.log
+'
 test_done
@@ -292,4 +292,28 @@ test_expect_success 'attach: EPERM generates sensible error' '
 	test_debug "cat eperm.err" &&
 	grep -i "not your job" eperm.err
 '
+test_expect_success 'attach: consecutive output is coalesced into fewer events' '
+	id=$(flux submit seq 1000) &&
+	flux job attach $id >seq.out &&
+	seq 1000 >seq.expected &&
+	test_cmp seq.expected seq.out &&
+	flux job eventlog -p output $id | grep -c " data " >seq.count &&
+	test_debug "cat seq.count" &&
+	test $(cat seq.count) -lt 1000
+'
+test_expect_success 'attach: --label-io labels each line of coalesced output' '
+	flux job attach --label-io $id >seq-label.out &&
+	seq 1000 | sed "s/^/0: /" >seq-label.expected &&
+	test_cmp seq-label.expected seq-label.out
+'
+test_expect_success 'attach: output written over time is coalesced' '
+	id=$(flux submit bash -c \
+		"for i in \$(seq 50); do echo \$i; sleep 0.002; done") &&
+	flux job attach $id >slow.out &&
+	seq 50 >slow.expected &&
+	test_cmp slow.expected slow.out &&
+	flux job eventlog -p output $id | grep -c " data " >slow.count &&
+	test_debug "cat slow.count" &&
+	test $(cat slow.count) -lt 25
+'
 test_done
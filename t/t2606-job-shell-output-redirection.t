@@ -432,4 +432,25 @@ test_expect_success 'job-shell: open of invalid output files fails' '
 	test_must_fail flux run -N4 -n8 \
 		--output=/nosuchdir/output.{{task.id}} hostname
 '
+test_expect_success 'job-shell: output from remote shells is complete' '
+	flux run -N4 -n4 --label-io seq 10000 >remote.out &&
+	for rank in $(seq 0 3); do
+		test $(grep -c "^${rank}: " remote.out) -eq 10000 || return 1
+	done
+'
+test_expect_success 'job-shell: compressed output from remote shells works' '
+	flux run -N4 -n4 -o output.compress --label-io seq 10000 \
+		>remote-lz4.out &&
+	sort remote.out >remote.sorted &&
+	sort remote-lz4.out >remote-lz4.sorted &&
+	test_cmp remote.sorted remote-lz4.sorted
+'
+test_expect_success 'job-shell: compressed output to a single file works' '
+	flux run -N4 -n4 -o output.compress --output=single-lz4.out \
+		seq 10000 &&
+	test $(wc -l <single-lz4.out) -eq 40000
+'
+test_expect_success 'job-shell: invalid output.compress option fails' '
+	test_must_fail flux run -N4 -o output.compress=foo true
+'
 test_done
@@ -60,6 +60,33 @@ for topic in "shell.init" "shell.exit" \
     "
 done
 
+test_expect_success 'flux-shell: log messages from all shells are merged' '
+	id=$(flux submit -o verbose=2 -o initrc=log.lua -n2 -N2 hostname) &&
+	flux job wait-event -t 30 $id clean &&
+	flux job eventlog --format=json -p output $id \
+		| jq -r "select(.name == \"log\")
+			| select(.context.message == \"task.init: log message\")
+			| .context.rank" \
+		>merged-ranks.out &&
+	test_debug "cat merged-ranks.out" &&
+	test $(wc -l <merged-ranks.out) -eq 1 &&
+	grep -x "0-1" merged-ranks.out &&
+	flux job attach $id 2>merged-attach.err &&
+	grep "flux-shell\[0\]: log: task.init: log message" merged-attach.err &&
+	grep "flux-shell\[1\]: log: task.init: log message" merged-attach.err
+'
+
+test_expect_success 'flux-shell: log messages after shell.start are not merged' '
+	flux job eventlog --format=json -p output $id \
+		| jq -r "select(.name == \"log\")
+			| select(.context.message == \"task.exit: log message\")
+			| .context.rank" \
+		| sort >exit-ranks.out &&
+	test_debug "cat exit-ranks.out" &&
+	printf "0\n1\n" >exit-ranks.expected &&
+	test_cmp exit-ranks.expected exit-ranks.out
+'
+
 test_expect_success 'flux-shell: run job with normal logging level' '
 	flux run -o initrc=log.lua -n2 -N2 hostname \
 		>log-test.output 2>log-test.err
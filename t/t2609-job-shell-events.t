@@ -39,4 +39,26 @@ test_expect_success 'flux-shell: plugin can add event context' '
 		-m event-test=foo ${id} shell.init
 
 '
+test_expect_success 'flux-shell: shell.start event includes launch timing' '
+	id=$(flux submit -n4 -N2 true) &&
+	flux job wait-event -t 5 -p exec -f json ${id} shell.start \
+		| jq -e ".context.timing | has(\"init\") and has(\"render\")
+			and has(\"fork\") and has(\"forked\")
+			and .total >= 0"
+'
+test_expect_success 'flux-shell: task-launch=phased runs all tasks' '
+	flux run -n4 -N2 -o task-launch=phased --label-io \
+		sh -c "echo \$FLUX_TASK_RANK" | sort >phased.out &&
+	cat >phased.expected <<-EOF &&
+	0: 0
+	1: 1
+	2: 2
+	3: 3
+	EOF
+	test_cmp phased.expected phased.out
+'
+test_expect_success 'flux-shell: invalid task-launch mode fails' '
+	test_must_fail flux run -o task-launch=foo true 2>launch.err &&
+	grep "invalid task-launch shell option" launch.err
+'
 test_done
@@ -147,4 +147,16 @@ test_expect_success 'Verify that example 2 of flux-archive(1) works' '
 	flux archive remove --name=app
 '
 
+test_expect_success 'archive files with more chunks than the fetch window' '
+	mkdir many &&
+	dd if=/dev/urandom of=many/a bs=4096 count=40 &&
+	dd if=/dev/urandom of=many/b bs=4096 count=24 &&
+	echo small >many/c &&
+	flux archive create --name=many --chunksize=4096 many
+'
+test_expect_success 'verify that stage-in of many chunks works' '
+	flux run -N4 -o stage-in.names=many ./check.sh many &&
+	flux archive remove --name=many
+'
+
 test_done
@@ -109,6 +109,41 @@ test_expect_success 'kvstest works with -o pmi-simple.exchange.k=SIZE+1' '
 	grep "using k=${SIZE}" kvstest_kp1.err
 '
 
+test_expect_success 'kvstest uses TBON-aligned exchange tree by default' '
+	flux run -n${SIZE} -N${SIZE} -o verbose=2 ${kvstest} 2>kvstest_tbon.err &&
+	grep "using TBON-aligned exchange tree" kvstest_tbon.err
+'
+test_expect_success 'kvstest works with TBON-aligned tree on a rank subset' '
+	flux run -n2 -N2 --requires=rank:$((${SIZE}-2))-$((${SIZE}-1)) \
+		${kvstest}
+'
+
+# With kary:2 on 7 brokers, ranks 3-6 have no TBON ancestor in the job,
+# so shells 1-3 form a binary tree under shell 0 rather than a flat one.
+test_expect_success 'orphaned shells form a k-ary exchange tree' '
+	flux start -s7 -Stbon.topo=kary:2 \
+		flux run -n4 -N4 --requires=rank:3-6 -o verbose=2 ${kvstest} \
+		2>kvstest_orphan.err &&
+	grep "flux-shell\[0\]: DEBUG: pmi-simple: exchange tree: 2 children" \
+		kvstest_orphan.err &&
+	grep "flux-shell\[1\]: DEBUG: pmi-simple: exchange tree: 1 children" \
+		kvstest_orphan.err &&
+	grep "flux-shell\[2\]: DEBUG: pmi-simple: exchange tree: 0 children" \
+		kvstest_orphan.err &&
+	grep "flux-shell\[3\]: DEBUG: pmi-simple: exchange tree: 0 children" \
+		kvstest_orphan.err
+'
+
+test_expect_success 'kvstest works with -o pmi-simple.kvs=direct' '
+	flux run -n${SIZE} -N${SIZE} -o pmi-simple.kvs=direct ${kvstest}
+'
+test_expect_success 'pmi_info works with -o pmi-simple.kvs=direct' '
+	flux run -n${SIZE} -N${SIZE} -o pmi-simple.kvs=direct ${pmi_info}
+'
+test_expect_success 'kvstest works with -o pmi-simple.kvs=direct on 1 node' '
+	flux run -n2 -N1 -o pmi-simple.kvs=direct ${kvstest}
+'
+
 test_expect_success 'kvstest fails with -o pmi-simple.kvs=unknown' '
 	test_must_fail flux run -o pmi-simple.kvs=unknown ${kvstest}
 '